@@ -0,0 +1,130 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "game_state.h"
+
+/* Valor de las celdas de relleno del layout en tiles: no es recompensa (> 0)
+ * ni rastro de jugador (-id), así que ninguna consulta las cuenta. */
+#define BOARD_CELL_VOID INT_MIN
+
+/* Posición de (x, y) dentro de GameState.board según el layout del segmento.
+ * En BOARD_LAYOUT_TILED los 8 vecinos de una celda caen en a lo sumo 4 tiles
+ * contiguos de 256 bytes, en vez de en tres filas separadas por width celdas. */
+static inline size_t board_index(const GameState *state, unsigned int x, unsigned int y)
+{
+    if (state->board_layout == BOARD_LAYOUT_TILED)
+    {
+        size_t tile = (size_t)(y >> BOARD_TILE_SHIFT) * BOARD_TILES(state->width) + (x >> BOARD_TILE_SHIFT);
+        return (tile << (2 * BOARD_TILE_SHIFT)) +
+               ((y & (BOARD_TILE_SIZE - 1)) << BOARD_TILE_SHIFT) + (x & (BOARD_TILE_SIZE - 1));
+    }
+    return (size_t)y * state->width + x;
+}
+
+static inline bool board_in_bounds(const GameState *state, int x, int y)
+{
+    return x >= 0 && y >= 0 && x < (int)state->width && y < (int)state->height;
+}
+
+/* Recompensa (1..9) de (x, y) en un tablero procedural: splitmix64 sobre la
+ * semilla y las coordenadas, así que cualquier proceso la calcula sin tocar
+ * el almacenamiento y la misma semilla da siempre el mismo mundo. */
+static inline int board_procedural_reward(uint32_t seed, unsigned int x, unsigned int y)
+{
+    uint64_t z = ((uint64_t)seed << 40) ^ ((uint64_t)y << 20) ^ x;
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return 1 + (int)(z % 9);
+}
+
+static inline size_t board_chunk_index(const GameState *state, unsigned int x, unsigned int y)
+{
+    return (size_t)(y >> BOARD_TILE_SHIFT) * BOARD_TILES(state->width) + (x >> BOARD_TILE_SHIFT);
+}
+
+static inline uint64_t *board_chunk_map(const GameState *state)
+{
+    return (uint64_t *)((uint8_t *)state + state->chunk_map_offset);
+}
+
+static inline uint64_t *board_chunk_summary(const GameState *state)
+{
+    return board_chunk_map(state) + BOARD_CHUNK_WORDS(state->width, state->height);
+}
+
+/* El bit se publica con release después de escribir el tile, así que quien lo
+ * ve encendido (incluso sin lock, como spectator_server) ve el tile completo. */
+static inline bool board_chunk_materialised(const GameState *state, unsigned int x, unsigned int y)
+{
+    size_t chunk = board_chunk_index(state, x, y);
+    uint64_t bits = __atomic_load_n(&board_chunk_map(state)[chunk >> 6], __ATOMIC_ACQUIRE);
+    return (bits >> (chunk & 63)) & 1u;
+}
+
+/* Escribe en el almacenamiento el tile que contiene (x, y) con sus
+ * recompensas procedurales. Sólo la llama el escritor (el master). */
+static inline void board_materialise_chunk(GameState *state, unsigned int x, unsigned int y)
+{
+    unsigned int x0 = x & ~(BOARD_TILE_SIZE - 1);
+    unsigned int y0 = y & ~(BOARD_TILE_SIZE - 1);
+    int *tile = &state->board[board_index(state, x0, y0)];
+    for (unsigned int dy = 0; dy < BOARD_TILE_SIZE; dy++)
+    {
+        for (unsigned int dx = 0; dx < BOARD_TILE_SIZE; dx++)
+        {
+            unsigned int cx = x0 + dx, cy = y0 + dy;
+            tile[(dy << BOARD_TILE_SHIFT) + dx] = (cx < state->width && cy < state->height)
+                                                      ? board_procedural_reward(state->board_seed, cx, cy)
+                                                      : BOARD_CELL_VOID;
+        }
+    }
+    size_t chunk = board_chunk_index(state, x, y);
+    size_t word = chunk >> 6;
+    __atomic_fetch_or(&board_chunk_map(state)[word], (uint64_t)1 << (chunk & 63), __ATOMIC_RELEASE);
+    __atomic_fetch_or(&board_chunk_summary(state)[word >> 6], (uint64_t)1 << (word & 63), __ATOMIC_RELEASE);
+}
+
+static inline int board_get(const GameState *state, unsigned int x, unsigned int y)
+{
+    if (state->board_mode == BOARD_MODE_PROCEDURAL && !board_chunk_materialised(state, x, y))
+        return board_procedural_reward(state->board_seed, x, y);
+    return state->board[board_index(state, x, y)];
+}
+
+static inline void board_set(GameState *state, unsigned int x, unsigned int y, int value)
+{
+    if (state->board_mode == BOARD_MODE_PROCEDURAL && !board_chunk_materialised(state, x, y))
+        board_materialise_chunk(state, x, y);
+    state->board[board_index(state, x, y)] = value;
+}
+
+/* Parsea "rowmajor" o "tiled". Devuelve false si no es ninguno. */
+static inline bool board_layout_parse(const char *name, BoardLayout *out)
+{
+    if (name[0] == 'r' && strcmp(name, "rowmajor") == 0)
+        *out = BOARD_LAYOUT_ROW_MAJOR;
+    else if (name[0] == 't' && strcmp(name, "tiled") == 0)
+        *out = BOARD_LAYOUT_TILED;
+    else
+        return false;
+    return true;
+}
+
+static inline const char *board_layout_name(BoardLayout layout)
+{
+    return layout == BOARD_LAYOUT_TILED ? "tiled" : "rowmajor";
+}
+
+static inline const char *board_mode_name(BoardMode mode)
+{
+    return mode == BOARD_MODE_PROCEDURAL ? "procedural" : "eager";
+}
+
+#endif /* BOARD_H */
@@ -0,0 +1,66 @@
+#ifndef BOARD_FILE_H
+#define BOARD_FILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "constants.h"
+#include "game_state.h"
+
+/* Archivo de tablero: una cabecera de 24 bytes en little-endian y después las
+ * width * height celdas en orden de fila, un int8_t cada una: 1..9 es una
+ * recompensa y -id (0 incluido) el rastro del jugador id. El checksum cubre
+ * las celdas, así que dos archivos con el mismo checksum son el mismo mapa en
+ * cualquier máquina (a diferencia de srand + rand, que depende de la libc). */
+
+#define BOARD_FILE_MAGIC 0x44524248u /* "HBRD" en little-endian */
+#define BOARD_FILE_VERSION 1
+#define BOARD_FILE_HEADER_SIZE 24
+
+/* Cabecera ya decodificada; en el archivo los campos van en este orden */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t checksum;
+} BoardFileHeader;
+
+static inline bool board_file_cell_valid(int value)
+{
+    return value <= 9 && value > -MAX_PLAYERS;
+}
+
+typedef struct BoardFileCDT *BoardFileADT;
+
+/* Proyecta el archivo con mmap y valida cabecera, tamaño, rango de las celdas
+ * y checksum. Los errores se informan por stderr; devuelve NULL. */
+BoardFileADT board_file_open(const char *path);
+
+void board_file_close(BoardFileADT bf);
+
+unsigned int board_file_width(BoardFileADT bf);
+unsigned int board_file_height(BoardFileADT bf);
+uint64_t board_file_checksum(BoardFileADT bf);
+
+/* Celdas en orden de fila, válidas hasta board_file_close */
+const int8_t *board_file_cells(BoardFileADT bf);
+
+/* Mayor id con rastro en el tablero, -1 si no hay ninguno */
+int board_file_max_owner(BoardFileADT bf);
+
+/* Copia el tablero a state, que debe tener sus dimensiones y estar en modo
+ * eager. Las celdas de relleno del layout quedan en BOARD_CELL_VOID. */
+void board_file_load(BoardFileADT bf, GameState *state);
+
+/* Checksum de un tablero en orden de fila (el que guarda la cabecera) */
+uint64_t board_file_hash(const int8_t *cells, unsigned int width, unsigned int height);
+
+/* Escribe un archivo a partir de celdas en orden de fila, sobre path.tmp +
+ * rename. No valida las celdas. */
+bool board_file_write(const char *path, unsigned int width, unsigned int height, const int8_t *cells);
+
+/* Vuelca el tablero de state (cualquier layout o modo) fila por fila */
+bool board_file_save(const char *path, const GameState *state);
+
+#endif /* BOARD_FILE_H */
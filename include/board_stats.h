@@ -0,0 +1,36 @@
+#ifndef BOARD_STATS_H
+#define BOARD_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_state.h"
+
+/* Resumen de un conjunto de celdas en una sola pasada. Las celdas de relleno
+ * (BOARD_CELL_VOID) no cuentan como libres ni como territorio. */
+typedef struct
+{
+    uint64_t free_cells;               /* celdas con recompensa (> 0) */
+    uint64_t reward_sum;               /* suma de esas recompensas */
+    uint64_t owned_cells[MAX_PLAYERS]; /* celdas con -id de cada jugador */
+    uint64_t unexplored_cells;         /* procedural: celdas de tiles sin materializar, fuera de las sumas */
+} BoardStats;
+
+/* Acumula en stats las celdas cells[0, count). El kernel (avx2, sse2 o
+ * escalar) se elige en el primer uso según la CPU; BOARD_STATS_KERNEL=scalar|sse2
+ * en el entorno lo limita, para comparar. */
+void board_stats_accumulate(const int *cells, size_t count, BoardStats *stats);
+
+/* Nombre del kernel elegido */
+const char *board_stats_kernel_name(void);
+
+/* Estadísticas de todo el tablero. En modo procedural sólo recorre los tiles
+ * materializados; el resto se informa en unexplored_cells. */
+void board_stats_board(const GameState *state, BoardStats *out);
+
+/* Estadísticas del rectángulo [x0, x0 + w) x [y0, y0 + h), recortado al
+ * tablero; con h = 1 da el resumen de un tramo de fila. En modo procedural
+ * las celdas sin materializar se evalúan con su recompensa procedural. */
+void board_stats_rect(const GameState *state, unsigned int x0, unsigned int y0, unsigned int w, unsigned int h,
+                      BoardStats *out);
+
+#endif /* BOARD_STATS_H */
@@ -0,0 +1,43 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_state.h"
+#include "move_sched.h"
+
+#define CHECKPOINT_MAGIC 0x4B504348u /* "HCPK" en little-endian */
+#define CHECKPOINT_VERSION 2
+
+/* Estado del master que no vive en GameState. El RNG sólo se consume en
+ * init_game_state, así que la semilla junto con el tablero lo describe. */
+typedef struct
+{
+    uint32_t seed;
+    uint32_t current_player_turn;
+    int64_t ms_since_last_valid_move;
+    MoveSchedSnapshot move_sched; /* policy en rotation (0) con -j/-i */
+} CheckpointMeta;
+
+typedef struct CheckpointCDT *CheckpointADT;
+
+/* Crea el escritor de checkpoints para segmentos de state_size bytes. Las
+ * escrituras se hacen en un hilo propio sobre path.tmp + rename. */
+CheckpointADT checkpoint_create(const char *path, size_t state_size);
+
+/* Copia el estado (el llamador debe garantizar que no cambia durante la copia)
+ * y encarga su escritura asíncrona. Devuelve false sin copiar nada si la
+ * escritura anterior sigue en curso. */
+bool checkpoint_submit(CheckpointADT cp, const GameState *state, const CheckpointMeta *meta);
+
+/* Escribe el estado de forma síncrona, esperando a la escritura en curso */
+bool checkpoint_write_now(CheckpointADT cp, const GameState *state, const CheckpointMeta *meta);
+
+/* Espera la escritura pendiente y libera el escritor */
+void checkpoint_destroy(CheckpointADT cp);
+
+/* Carga un checkpoint. *out_state se reserva con malloc y mide *out_size bytes. */
+bool checkpoint_load(const char *path, CheckpointMeta *out_meta, GameState **out_state, size_t *out_size);
+
+#endif /* CHECKPOINT_H */
@@ -13,9 +13,25 @@
 #define DEFAULT_DELAY 200 //ms
 #define DEFAULT_TIMEOUT 10 //s
 #define DEFAULT_VIEW_PATH NULL
+#define DEFAULT_CHECKPOINT_INTERVAL_MS 1000
 #define MIN_PLAYERS 1
 #define MIN_WIDTH 10
 #define MIN_HEIGHT 10
+#define MAX_WIDTH (1u << 20)
+#define MAX_HEIGHT (1u << 20)
+// -B con -g recorre (y materializa) cada celda: 256 MiB de archivo como tope
+#define MAX_PROCEDURAL_DUMP_CELLS (1ull << 28)
+
+// Protocolo de movimientos: un byte < MOVE_PLAN_FLAG es un movimiento suelto;
+// un byte (MOVE_PLAN_FLAG | n) anuncia un plan de n direcciones a continuación.
+#define DEFAULT_MOVE_CREDITS 1
+#define MAX_MOVE_CREDITS 16
+#define MOVE_PLAN_FLAG 0x80
+#define MOVE_PLAN_LEN_MASK 0x7F
+#define MAX_MOVE_JOBS 64
+
+// Tamaño de línea de caché usado para separar datos compartidos calientes
+#define CACHE_LINE_SIZE 64
 
 #define R_END 0
 #define W_END 1
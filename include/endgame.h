@@ -0,0 +1,44 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <stdbool.h>
+#include "search_position.h"
+
+/* Final de partida en una región sellada: si ningún rival puede entrar en la
+ * región del jugador, lo que le queda por ganar no depende de nadie más y es
+ * el camino simple de mayor recompensa dentro de ella (movimientos de rey,
+ * puede terminar en cualquier celda).
+ *
+ * Hasta ENDGAME_EXACT_CELLS celdas se resuelve exacto: ramificación y poda
+ * con la recompensa alcanzable como cota y memoria de los estados (celdas
+ * visitadas, celda actual) ya explorados, sobre máscaras de 64 bits. Si no
+ * termina dentro del presupuesto, o la región es más grande, queda el mejor
+ * camino hallado, que arranca de uno goloso: en cada paso la celda que deja
+ * más recompensa alcanzable y, a igualdad, la de menos salidas (Warnsdorff),
+ * para ir pegado a las paredes sin partir la región. */
+
+#define ENDGAME_EXACT_CELLS 64
+#define ENDGAME_MAX_PLAN 256 /* los caminos más largos se completan en otra llamada */
+
+typedef struct EndgameCDT *EndgameADT;
+
+typedef struct
+{
+    bool exact;  /* el camino es óptimo para toda la región */
+    int cells;   /* celdas de la región */
+    int value;   /* recompensa del camino */
+    int len;
+    unsigned char moves[ENDGAME_MAX_PLAN];
+    int x[ENDGAME_MAX_PLAN], y[ENDGAME_MAX_PLAN]; /* celda del tablero tras cada paso */
+} EndgamePlan;
+
+/* Devuelve NULL con errno */
+EndgameADT endgame_create(void);
+
+void endgame_destroy(EndgameADT eg);
+
+/* Si la región de pos->me está sellada, deja en plan el camino y devuelve
+ * true. Con una región abierta (o sin movimientos) devuelve false. */
+bool endgame_solve(EndgameADT eg, const SearchPosition *pos, unsigned int budget_ms, EndgamePlan *plan);
+
+#endif /* ENDGAME_H */
@@ -0,0 +1,33 @@
+#ifndef GAME_RULES_H
+#define GAME_RULES_H
+
+#include <stdbool.h>
+#include "game_state.h"
+
+/* Reglas del juego sobre un GameState, sin procesos ni sincronización: las
+ * usan el master (con el lock de escritor tomado) y el simulador selfplay
+ * (sobre un estado privado de cada hilo). */
+
+#define GAME_DIRECTIONS 8
+
+/* Desplazamiento de cada dirección: 0 = arriba y en sentido horario */
+extern const int GAME_DIR_DX[GAME_DIRECTIONS];
+extern const int GAME_DIR_DY[GAME_DIRECTIONS];
+
+/* Ubica a los player_count jugadores de state en una elipse alrededor del
+ * centro, con puntaje y contadores en cero, y marca sus celdas como ocupadas.
+ * No toca player_info. */
+void game_rules_spawn_players(GameState *state);
+
+/* Aplica un movimiento y devuelve si fue válido: la celda destino tiene que
+ * estar en el tablero y libre. Sólo toca al jugador y a la celda destino
+ * (ver MoveApplyFn en move_batch.h). */
+bool game_rules_apply_move(GameState *state, int player, unsigned char move);
+
+/* Si el jugador tiene alguna celda libre vecina */
+bool game_rules_can_move(const GameState *state, int player);
+
+/* Si algún jugador no bloqueado puede moverse */
+bool game_rules_any_can_move(const GameState *state);
+
+#endif /* GAME_RULES_H */
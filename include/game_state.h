@@ -2,30 +2,108 @@
 #define GAME_STATE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <sys/types.h>
 #include "constants.h"
+#include "shmADT.h"
 
+#define GAME_STATE_MAGIC 0x53474D45u /* "EMGS" en little-endian */
+#define GAME_STATE_VERSION 5
+
+/* Orden de las celdas en GameState.board. Acceder siempre con board_index /
+ * board_get (board.h), nunca indexando a mano. */
+typedef enum
+{
+    BOARD_LAYOUT_ROW_MAJOR = 0, /* fila 0, fila 1, ... */
+    BOARD_LAYOUT_TILED = 1      /* tiles de BOARD_TILE_SIZE x BOARD_TILE_SIZE, en orden de fila */
+} BoardLayout;
+
+/* Origen de las recompensas. En BOARD_MODE_PROCEDURAL el tablero no se
+ * escribe al crear la partida: una celda vale board_procedural_reward(seed, x, y)
+ * hasta que su tile se materializa en el almacenamiento (board.h), lo que
+ * ocurre la primera vez que el master escribe en él. Exige BOARD_LAYOUT_TILED:
+ * el tile es la unidad de materialización. */
+typedef enum
+{
+    BOARD_MODE_EAGER = 0,     /* el master escribe todas las celdas al iniciar */
+    BOARD_MODE_PROCEDURAL = 1 /* recompensas por hash, almacenamiento perezoso por tile */
+} BoardMode;
+
+#define BOARD_TILE_SHIFT 3
+#define BOARD_TILE_SIZE (1u << BOARD_TILE_SHIFT) /* 8x8 ints = 256 bytes = 4 líneas de caché */
+#define BOARD_TILES(n) (((size_t)(n) + BOARD_TILE_SIZE - 1) >> BOARD_TILE_SHIFT)
+#define BOARD_STORAGE_CELLS(w, h, layout)                                                  \
+    ((layout) == BOARD_LAYOUT_TILED                                                       \
+         ? BOARD_TILES(w) * BOARD_TILES(h) * (size_t)BOARD_TILE_SIZE * BOARD_TILE_SIZE     \
+         : (size_t)(w) * (size_t)(h))
+/* Mapa de tiles materializados, tras el tablero: un bit por tile y, a
+ * continuación, un bit de resumen por palabra de 64 tiles, para que recorrer
+ * los tiles materializados cueste lo explorado y no lo declarado. */
+#define BOARD_CHUNK_WORDS(w, h) ((BOARD_TILES(w) * BOARD_TILES(h) + 63) / 64)
+#define BOARD_CHUNK_SUMMARY_WORDS(w, h) ((BOARD_CHUNK_WORDS(w, h) + 63) / 64)
+#define BOARD_CHUNK_MAP_BYTES(w, h, layout)                                                          \
+    ((layout) == BOARD_LAYOUT_TILED ? (BOARD_CHUNK_WORDS(w, h) + BOARD_CHUNK_SUMMARY_WORDS(w, h)) * sizeof(uint64_t) \
+                                    : (size_t)0)
+
+/* Datos calientes de cada jugador: los escribe el master en cada movimiento,
+ * así que cada uno ocupa su propia línea de caché. */
 typedef struct
 {
-    char name[16];
-    unsigned int score;
+    _Alignas(CACHE_LINE_SIZE) unsigned int score;
     unsigned int invalid_move_requests;
     unsigned int valid_move_requests;
-    unsigned short x, y;
-    pid_t pid; /* not to be printed by view */
+    unsigned int x, y;
     bool blocked;
 } Player;
 
+/* Datos fríos: se escriben una vez al lanzar la partida */
 typedef struct
 {
-    unsigned short width;
-    unsigned short height;
-    unsigned int player_count;
+    char name[16];
+    pid_t pid; /* not to be printed by view */
+} PlayerInfo;
+
+typedef struct
+{
+    /* Cabecera autodescriptiva: la escribe el master al crear el segmento, antes
+     * de lanzar a ningún hijo, y los consumidores dimensionan su mapeo con ella. */
+    struct
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t map_size;       /* bytes totales del segmento */
+        uint32_t players_offset; /* offsetof(GameState, players) */
+        uint32_t player_info_offset;
+        uint32_t board_offset;
+        uint32_t width;
+        uint32_t height;
+        uint32_t board_layout; /* BoardLayout */
+        uint32_t board_mode;   /* BoardMode */
+        uint32_t board_seed;   /* semilla de board_procedural_reward */
+        uint64_t chunk_map_offset; /* mapa de tiles materializados, sólo en BOARD_LAYOUT_TILED */
+        unsigned int player_count;
+        unsigned int move_credits; /* movimientos que un jugador puede tener en vuelo */
+    };
+    _Alignas(CACHE_LINE_SIZE) bool finished;
+    PlayerInfo player_info[MAX_PLAYERS];
     Player players[MAX_PLAYERS];
-    bool finished;
-    int board[]; /* row-major: row-0, row-1, ..., row-(height-1) */
+    _Alignas(CACHE_LINE_SIZE) int board[]; /* según board_layout; las celdas de relleno valen BOARD_CELL_VOID */
 } GameState;
 
-#define GAME_STATE_MAP_SIZE(w, h) (sizeof(GameState) + (size_t)(w) * (size_t)(h) * sizeof(int))
+#define GAME_STATE_CHUNK_MAP_OFFSET(w, h, layout) (sizeof(GameState) + BOARD_STORAGE_CELLS(w, h, layout) * sizeof(int))
+#define GAME_STATE_MAP_SIZE(w, h, layout) \
+    (GAME_STATE_CHUNK_MAP_OFFSET(w, h, layout) + BOARD_CHUNK_MAP_BYTES(w, h, layout))
+
+/* Completa la cabecera de un segmento recién creado de GAME_STATE_MAP_SIZE(w, h, layout) bytes.
+ * El segmento se mapea con MAP_NORESERVE: en modo procedural sólo ocupan
+ * memoria las páginas de los tiles materializados. */
+void game_state_init_header(GameState *state, uint32_t width, uint32_t height, BoardLayout layout,
+                            BoardMode mode, uint32_t seed);
+
+/* Abre GAME_STATE_SHM_NAME en sólo lectura dimensionando el mapeo a partir de la
+ * cabecera. Devuelve NULL (con el error informado en stderr con el prefijo who)
+ * si el segmento no existe o su layout no coincide con el compilado. */
+ShmADT game_state_open(const char *who, GameState **out_state);
 
 #endif /* GAME_STATE_H */
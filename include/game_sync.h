@@ -2,21 +2,71 @@
 #define GAME_SYNC_H
 
 #include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include "constants.h"
 
+/* Semáforo aislado en su propia línea de caché */
 typedef struct
 {
-    sem_t view_update_ready;            /* master -> view: state changed */
-    sem_t view_print_done;              /* view -> master: printing completed */
-    sem_t master_starvation_guard;      /* mutex: protect master access to state */
-    sem_t state_mutex;                  /* mutex for game state */
-    sem_t readers_count_mutex;          /* mutex for readers_count */
-    unsigned int readers_count;         /* number of views/players reading state */
-    sem_t player_can_move[MAX_PLAYERS]; /* per-player movement slot */
+    _Alignas(CACHE_LINE_SIZE) sem_t sem;
+} PaddedSem;
+
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) sem_t view_update_ready;       /* master -> view: state changed */
+    _Alignas(CACHE_LINE_SIZE) sem_t view_print_done;         /* view -> master: printing completed */
+    _Alignas(CACHE_LINE_SIZE) sem_t master_starvation_guard; /* mutex: protect master access to state */
+    _Alignas(CACHE_LINE_SIZE) sem_t state_mutex;             /* mutex for game state */
+    _Alignas(CACHE_LINE_SIZE) sem_t readers_count_mutex;     /* mutex for readers_count */
+    unsigned int readers_count;                              /* same line as its mutex: always used together */
+    PaddedSem player_can_move[MAX_PLAYERS];                  /* per-player movement slot */
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint32_t state_seq;   /* seqlock: impar mientras el master escribe */
+    _Atomic uint32_t state_generation;                       /* master -> espectadores: sube con cada cambio */
+    _Atomic uint32_t spectator_waiters;                      /* espectadores dormidos sobre state_generation */
 } GameSync;
 
 /* Reader-side of fair RW-lock used by view/player (writers handled by master) */
 void game_sync_reader_enter(GameSync *sync);
 void game_sync_reader_exit(GameSync *sync);
 
+/* Writer-side (master): pasa por el torniquete y toma state_mutex en exclusiva.
+ * Además lleva state_seq a impar al entrar y a par al salir. */
+void game_sync_writer_enter(GameSync *sync);
+void game_sync_writer_exit(GameSync *sync);
+
+/* Lectura sin lock para los espectadores, que no deben poder trabar al master
+ * (un espectador detenido o muerto con el lock tomado lo bloquearía): tomar la
+ * secuencia, copiar y preguntar si hay que reintentar, que es cuando la copia
+ * se cruzó con una sección de escritor. */
+static inline uint32_t game_sync_read_begin(GameSync *sync)
+{
+    return atomic_load_explicit(&sync->state_seq, memory_order_acquire);
+}
+
+static inline bool game_sync_read_retry(GameSync *sync, uint32_t begin)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return (begin & 1u) || atomic_load_explicit(&sync->state_seq, memory_order_relaxed) != begin;
+}
+
+/* Difusión a espectadores: a diferencia de view_update_ready/view_print_done,
+ * que atan al master con una única vista, cualquier cantidad de procesos puede
+ * esperar cambios de state_generation y entrar o salir en cualquier momento.
+ * El master sólo incrementa el contador y, si hay alguien dormido, los
+ * despierta a todos (futex en Linux); nunca espera a ninguno. */
+
+/* Master: anuncia un cambio de estado ya publicado (llamar sin el lock) */
+void game_sync_publish(GameSync *sync);
+
+static inline uint32_t game_sync_generation(GameSync *sync)
+{
+    return atomic_load_explicit(&sync->state_generation, memory_order_acquire);
+}
+
+/* Espectador: espera a que la generación deje de ser seen, a lo sumo
+ * timeout_ms. Devuelve true si cambió. Una señal lo despierta antes. */
+bool game_sync_wait_generation(GameSync *sync, uint32_t seen, unsigned int timeout_ms);
+
 #endif /* GAME_SYNC_H */
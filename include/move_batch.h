@@ -0,0 +1,44 @@
+#ifndef MOVE_BATCH_H
+#define MOVE_BATCH_H
+
+#include <stdbool.h>
+#include "constants.h"
+#include "game_state.h"
+
+/* Solicitud de un jugador dentro de una ronda de select */
+typedef struct
+{
+    int player;
+    unsigned int len; /* movimientos a aplicar, ya recortados a los créditos */
+    unsigned char plan[MOVE_PLAN_LEN_MASK];
+    unsigned int applied; /* salida: procesados, incluido el inválido que corta el plan */
+    unsigned int valid;   /* salida: cuántos de ellos fueron válidos */
+} MoveRequest;
+
+/* Aplica un movimiento y devuelve si fue válido. Sólo puede tocar al jugador
+ * y a la celda destino: dos movimientos hacia celdas distintas conmutan, que
+ * es lo que permite aplicar regiones disjuntas en paralelo. */
+typedef bool (*MoveApplyFn)(GameState *state, int player, unsigned char move);
+
+typedef struct MoveBatchCDT *MoveBatchADT;
+
+/* Crea un aplicador con workers hilos en total (el llamador de move_batch_run
+ * es uno de ellos; con 1 no se crea ninguno). Devuelve NULL con errno. */
+MoveBatchADT move_batch_create(unsigned int workers, MoveApplyFn apply);
+
+/* Aplica las solicitudes en fases: en la fase k se aplica el k-ésimo
+ * movimiento de cada plan que sigue vivo, en el orden de requests. Ante dos
+ * movimientos a la misma celda gana siempre el primero de requests.
+ *
+ * Las solicitudes cuyos planes pueden alcanzar tiles en común forman una
+ * región; las regiones no comparten celdas ni tiles, así que cada una la
+ * aplica entera un único hilo y el resultado es el mismo que en serie. Los
+ * hilos se despiertan una sola vez por lote, y sólo si hay al menos dos
+ * regiones y MOVE_BATCH_PARALLEL_MIN movimientos; si no, todo se aplica en el
+ * hilo que llama. El llamador debe tener el lock de escritor durante toda la
+ * llamada. */
+void move_batch_run(MoveBatchADT batch, GameState *state, MoveRequest *requests, int count);
+
+void move_batch_destroy(MoveBatchADT batch);
+
+#endif /* MOVE_BATCH_H */
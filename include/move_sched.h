@@ -0,0 +1,88 @@
+#ifndef MOVE_SCHED_H
+#define MOVE_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "constants.h"
+
+/* A quién atiende el master entre los jugadores que select() da por listos
+ * (modo de a un movimiento; -j y -i tienen su propio orden). Cada jugador
+ * tiene a lo sumo una solicitud pendiente, que "llega" cuando el master ve su
+ * pipe listo por primera vez; la espera se mide desde ahí hasta atenderla.
+ *
+ *   rotation      el primero listo desde el turno actual (el orden de siempre)
+ *   fifo          la llegada más antigua
+ *   drr[:q]       deficit round robin: cada ronda suma q movimientos de
+ *                 crédito y cada solicitud descuenta los que aplicó, así que
+ *                 un plan largo cuesta lo que mueve (q por defecto: -c)
+ *   edf[:ms]      earliest deadline first: el plazo de cada jugador vence ms
+ *                 después de su última atención (por defecto 10), así que el
+ *                 que lleva más tiempo sin ser atendido va primero
+ *
+ * Los empates se resuelven por rotación desde el turno. */
+
+typedef enum
+{
+    MOVE_SCHED_ROTATION = 0,
+    MOVE_SCHED_FIFO,
+    MOVE_SCHED_DRR,
+    MOVE_SCHED_EDF
+} MoveSchedPolicy;
+
+typedef struct
+{
+    MoveSchedPolicy policy;
+    unsigned int param; /* quantum de drr o plazo de edf en ms; 0 = por defecto */
+} MoveSchedConfig;
+
+/* Lo que se guarda en un checkpoint: la política, el turno, el crédito de drr
+ * y cuánto hacía que cada jugador no era atendido (el plazo de edf). Las
+ * llegadas pendientes no: al reanudar los jugadores se relanzan con el pipe
+ * vacío. Las esperas medidas tampoco; el informe es de cada corrida. */
+typedef struct
+{
+    uint32_t policy; /* MoveSchedPolicy */
+    uint32_t param;
+    uint32_t turn;
+    uint32_t player_count;
+    int64_t deficit[MAX_PLAYERS];
+    int64_t since_served_us[MAX_PLAYERS];
+} MoveSchedSnapshot;
+
+typedef struct MoveSchedCDT *MoveSchedADT;
+
+/* Parsea "rotation", "fifo", "drr[:quantum]" o "edf[:period_ms]" */
+bool move_sched_parse(const char *text, MoveSchedConfig *out);
+
+const char *move_sched_name(MoveSchedPolicy policy);
+
+/* default_quantum es el de drr sin parámetro (los créditos por solicitud).
+ * first_turn es el turno inicial (al reanudar un checkpoint). Devuelve NULL
+ * con errno. */
+MoveSchedADT move_sched_create(const MoveSchedConfig *cfg, int player_count, unsigned int default_quantum,
+                               int first_turn);
+
+void move_sched_destroy(MoveSchedADT sched);
+
+/* Anota el resultado de un select: ready[i] indica si el pipe de i está listo */
+void move_sched_observe(MoveSchedADT sched, const bool *ready);
+
+/* Elige a quién atender entre los listos; -1 si no hay ninguno */
+int move_sched_pick(MoveSchedADT sched);
+
+/* Registra que se atendió a player y cuántos movimientos se procesaron */
+void move_sched_served(MoveSchedADT sched, int player, unsigned int moves);
+
+/* Turno desde el que rota el desempate (lo que se guarda en un checkpoint) */
+int move_sched_turn(MoveSchedADT sched);
+
+void move_sched_snapshot(MoveSchedADT sched, MoveSchedSnapshot *out);
+
+/* Vuelve al estado guardado sobre un planificador recién creado con la misma
+ * política y cantidad de jugadores */
+void move_sched_restore(MoveSchedADT sched, const MoveSchedSnapshot *snap);
+
+/* Tasa de servicio, percentiles de espera e índice de Jain por stdout */
+void move_sched_print_report(MoveSchedADT sched, double seconds);
+
+#endif /* MOVE_SCHED_H */
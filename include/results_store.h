@@ -0,0 +1,115 @@
+#ifndef RESULTS_STORE_H
+#define RESULTS_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "constants.h"
+
+/* Almacén columnar de resultados, sólo de agregado. Es un directorio con un
+ * archivo por columna (arreglo plano de valores nativos, una fila por jugador
+ * y partida, las filas de una partida contiguas), un diccionario de binarios
+ * (una ruta por línea; el número de línea es el id) y un archivo meta con la
+ * cantidad de filas confirmadas. Al agregar se escriben primero las columnas y
+ * al final meta, bajo flock: una escritura cortada a medias queda fuera de
+ * meta y la próxima la trunca. */
+
+#define RESULTS_MAGIC 0x53455247u /* "GRES" en little-endian */
+#define RESULTS_VERSION 1
+#define RESULTS_META_FILE "meta"
+#define RESULTS_DICT_FILE "binaries.dict"
+
+typedef enum
+{
+    RESULTS_COL_GAME = 0,    /* u64: número de partida dentro del almacén */
+    RESULTS_COL_FINISHED_AT, /* u64: segundos Unix al agregar */
+    RESULTS_COL_SEED,        /* u32 */
+    RESULTS_COL_WIDTH,       /* u32 */
+    RESULTS_COL_HEIGHT,      /* u32 */
+    RESULTS_COL_DURATION_MS, /* u32 */
+    RESULTS_COL_PLAYERS,     /* u8: jugadores de la partida */
+    RESULTS_COL_SLOT,        /* u8: índice del jugador */
+    RESULTS_COL_RANK,        /* u8: 1 + jugadores con más puntaje (empates comparten puesto) */
+    RESULTS_COL_BINARY,      /* u32: id en el diccionario */
+    RESULTS_COL_SCORE,       /* u32 */
+    RESULTS_COL_VALID,       /* u32 */
+    RESULTS_COL_INVALID,     /* u32 */
+    RESULTS_COL_EXIT_STATUS, /* i32: status crudo de waitpid */
+    RESULTS_COL_COUNT
+} ResultsColumn;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t column_count;
+    uint32_t reserved;
+    uint64_t rows;  /* filas confirmadas */
+    uint64_t games; /* partidas confirmadas */
+} ResultsMeta;
+
+typedef struct
+{
+    const char *binary;
+    uint32_t score;
+    uint32_t valid;
+    uint32_t invalid;
+    int32_t exit_status;
+} PlayerResult;
+
+typedef struct
+{
+    uint32_t seed;
+    uint32_t width;
+    uint32_t height;
+    uint32_t duration_ms;
+    uint32_t player_count;
+    PlayerResult players[MAX_PLAYERS];
+} GameResult;
+
+/* Vista de sólo lectura de un almacén: cada columna mapeada con mmap */
+typedef struct
+{
+    uint64_t rows;
+    uint64_t games;
+    const void *columns[RESULTS_COL_COUNT];
+    size_t mapped[RESULTS_COL_COUNT]; /* bytes mapeados de cada columna */
+    char **binaries;                  /* diccionario, binary_count entradas */
+    uint32_t binary_count;
+    char *dict_data;
+} ResultsTable;
+
+/* Nombre de archivo y tamaño de elemento de cada columna */
+const char *results_column_name(ResultsColumn column);
+size_t results_column_size(ResultsColumn column);
+
+/* Agrega una partida al almacén dir, creándolo si hace falta. Es seguro con
+ * varios masters a la vez. Devuelve false con errno (y un mensaje en stderr). */
+bool results_append(const char *dir, const GameResult *result);
+
+/* Abre dir para leer. Sólo se ven las filas confirmadas al abrir. */
+bool results_open(const char *dir, ResultsTable *table);
+
+void results_close(ResultsTable *table);
+
+static inline const uint8_t *results_u8(const ResultsTable *t, ResultsColumn c)
+{
+    return (const uint8_t *)t->columns[c];
+}
+
+static inline const uint32_t *results_u32(const ResultsTable *t, ResultsColumn c)
+{
+    return (const uint32_t *)t->columns[c];
+}
+
+static inline const int32_t *results_i32(const ResultsTable *t, ResultsColumn c)
+{
+    return (const int32_t *)t->columns[c];
+}
+
+static inline const uint64_t *results_u64(const ResultsTable *t, ResultsColumn c)
+{
+    return (const uint64_t *)t->columns[c];
+}
+
+#endif /* RESULTS_STORE_H */
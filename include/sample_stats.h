@@ -0,0 +1,25 @@
+#ifndef SAMPLE_STATS_H
+#define SAMPLE_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Reloj y percentiles compartidos por las mediciones de latencia (sync_bench,
+ * loadgen, move_sched) y los plazos de la búsqueda. */
+
+static inline uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Ordena n muestras de menor a mayor */
+void sample_stats_sort(uint32_t *samples, size_t n);
+
+/* Percentil q (0..1) de n muestras ordenadas: la de índice floor(q * (n - 1)),
+ * así que q = 1 es el máximo. 0 si no hay muestras. */
+uint32_t sample_stats_percentile(const uint32_t *sorted, size_t n, double q);
+
+#endif /* SAMPLE_STATS_H */
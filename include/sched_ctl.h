@@ -0,0 +1,52 @@
+#ifndef SCHED_CTL_H
+#define SCHED_CTL_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+#define SCHED_CTL_MAX_CPUS 64
+
+/* Slots de proceso a los que se asigna CPU: master, vista y luego jugadores */
+#define SCHED_CTL_SLOT_MASTER 0
+#define SCHED_CTL_SLOT_VIEW 1
+#define SCHED_CTL_SLOT_PLAYER(i) (2 + (i))
+
+typedef struct
+{
+    bool enabled;                 /* -a presente */
+    bool automatic;               /* "auto": repartir por las CPUs en línea */
+    int cpus[SCHED_CTL_MAX_CPUS]; /* lista explícita, se recorre cíclicamente */
+    int cpu_count;
+} CpuPinning;
+
+typedef enum
+{
+    SCHED_CTL_DEFAULT = 0,
+    SCHED_CTL_FIFO, /* SCHED_FIFO con prioridad value */
+    SCHED_CTL_NICE  /* SCHED_OTHER con niceness value */
+} SchedPolicy;
+
+typedef struct
+{
+    SchedPolicy policy;
+    int value;
+} SchedSettings;
+
+/* "auto" o lista separada por comas ("0,2,4"). Devuelve false si es inválida. */
+bool sched_ctl_parse_cpus(const char *spec, CpuPinning *out);
+
+/* "fifo:<prio>" o "nice:<n>". Devuelve false si es inválida. */
+bool sched_ctl_parse_policy(const char *spec, SchedSettings *out);
+
+/* CPU asignada a un slot, o -1 si no hay pinning */
+int sched_ctl_cpu_for_slot(const CpuPinning *pinning, int slot);
+
+/* Aplica afinidad (cpu >= 0) y política al proceso que llama. Los errores se
+ * informan por stderr con el prefijo who y no son fatales. */
+void sched_ctl_apply_self(const char *who, int cpu, const SchedSettings *settings);
+
+/* Última CPU en la que corrió pid (0 = proceso actual), o -1 si no se sabe.
+ * Para hijos terminados solo es válido antes de cosecharlos con waitpid. */
+int sched_ctl_last_cpu(pid_t pid);
+
+#endif /* SCHED_CTL_H */
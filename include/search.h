@@ -0,0 +1,69 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+#include "search_position.h"
+
+/* Búsqueda alfa-beta paranoica con profundización iterativa: el jugador
+ * propio maximiza y los rivales cercanos, que mueven por turnos después de
+ * él, minimizan en coalición. Cada iteración ordena primero la variante
+ * principal de la anterior, después los movimientos killer de la capa y el
+ * resto por recompensa. Las hojas valen el puntaje más la recompensa del
+ * territorio de Voronoi de cada uno (ver voronoi.h). Al vencer el presupuesto
+ * devuelve lo mejor de la última iteración completa (o de la actual, si ya
+ * superó a esa).
+ *
+ * Con varios hilos la iteración se reparte en un pool con robo de trabajo:
+ * primero la variante principal y después el resto de los movimientos raíz,
+ * cada uno partido en una tarea por respuesta de la capa siguiente. Las
+ * tareas comparten sin locks la mejor cota de la raíz (que usan como alfa) y
+ * una cota por movimiento raíz, con la que una respuesta que lo refuta
+ * cancela a sus hermanas. Más abajo, todo nodo al que le quedan al menos
+ * SPLIT_MIN_DEPTH capas busca su primer hijo en serie y reparte el resto
+ * (young brothers wait), con la ventana del nodo compartida y un corte que
+ * anula a las hermanas pendientes.
+ *
+ * Las posiciones a las que se llega por distintos órdenes de movimientos se
+ * reconocen por su hash de Zobrist en una tabla de transposición común a
+ * todos los hilos (ver transposition.h), que además da el primer movimiento
+ * a probar en cada nodo. */
+
+#define SEARCH_MAX_PLY 64
+#define SEARCH_DEFAULT_BUDGET_MS 20
+#define SEARCH_OPPONENT_RADIUS 8 /* rivales más lejos (Chebyshev) quedan quietos */
+#define SEARCH_MAX_THREADS 64
+#define SEARCH_DEFAULT_TT_MB 16
+
+typedef struct
+{
+    unsigned int budget_ms; /* tiempo por movimiento */
+    unsigned int max_depth; /* en capas, a lo sumo SEARCH_MAX_PLY */
+    unsigned int threads;   /* hilos de búsqueda, contando al que llama */
+    unsigned int tt_mb;     /* memoria de la tabla de transposición; 0 = sin tabla */
+} SearchConfig;
+
+typedef struct
+{
+    int move;           /* dirección elegida; -1 si no hay movimientos */
+    int value;          /* evaluación desde el punto de vista propio */
+    unsigned int depth; /* última profundidad completa */
+    uint64_t nodes;
+    uint64_t tt_hits;   /* nodos resueltos por la tabla sin buscar */
+    bool exact;         /* el árbol se resolvió entero antes del límite de profundidad */
+} SearchResult;
+
+typedef struct SearchEngineCDT *SearchEngineADT;
+
+/* Lee SEARCH_BUDGET_MS, SEARCH_MAX_DEPTH, SEARCH_THREADS y SEARCH_TT_MB del
+ * entorno */
+void search_config_from_env(SearchConfig *cfg);
+
+/* Crea el motor y su pool de hilos. Devuelve NULL con errno. */
+SearchEngineADT search_engine_create(const SearchConfig *cfg);
+
+/* Busca desde pos (que no se modifica) para pos->me */
+SearchResult search_engine_best_move(SearchEngineADT engine, const SearchPosition *pos);
+
+void search_engine_destroy(SearchEngineADT engine);
+
+#endif /* SEARCH_H */
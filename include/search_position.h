@@ -0,0 +1,164 @@
+#ifndef SEARCH_POSITION_H
+#define SEARCH_POSITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game_state.h"
+
+/* Copia privada de una ventana del tablero alrededor del jugador, sobre la
+ * que busca search_player sin tocar el segmento. Está en bitboards de una
+ * palabra por fila: la columna wx de la ventana es el bit wx + 1 y la fila wy
+ * es la palabra wy + 1, así que los bits 0 y 63 y las filas 0 y 63 son muros y
+ * ningún vecino necesita chequeo de límites (ni los desplazamientos de una
+ * fila entera pierden celdas). Mover y deshacer son O(1), y actualizan un
+ * hash de Zobrist de los rastros y las cabezas. */
+
+#define SEARCH_WINDOW 62 /* lado máximo de la ventana, en celdas */
+#define SEARCH_ROWS 64
+#define SEARCH_STRIDE 64 /* celda = fila * SEARCH_STRIDE + bit */
+#define SEARCH_REWARD_PLANES 4 /* recompensas 1..9 en 4 bits */
+#define SEARCH_NO_CELL (-1)
+
+/* Bordes de la ventana que no son borde del tablero: del otro lado puede
+ * haber celdas libres y rivales que la copia no ve */
+#define SEARCH_EDGE_TOP 1u
+#define SEARCH_EDGE_RIGHT 2u
+#define SEARCH_EDGE_BOTTOM 4u
+#define SEARCH_EDGE_LEFT 8u
+
+typedef struct
+{
+    int x0, y0;        /* esquina de la ventana en el tablero */
+    int width, height; /* tamaño de la ventana */
+    int player_count;
+    int me;
+    unsigned int open_edges; /* SEARCH_EDGE_* */
+    uint64_t free[SEARCH_ROWS];                               /* celdas con recompensa */
+    uint64_t reward_plane[SEARCH_ROWS][SEARCH_REWARD_PLANES]; /* bit k de la recompensa; los planos de una fila, juntos */
+    uint64_t trail[MAX_PLAYERS][SEARCH_ROWS];                 /* celdas de cada jugador */
+    int head[MAX_PLAYERS]; /* celda de cada jugador; SEARCH_NO_CELL si está bloqueado o fuera */
+    int score[MAX_PLAYERS];
+    uint64_t hash; /* Zobrist de rastros y cabezas (el resto no cambia durante la búsqueda) */
+} SearchPosition;
+
+/* Desplazamiento de cada dirección (el mismo orden que GAME_DIR_DX/DY de game_rules.h) */
+extern const int SEARCH_DIR_OFFSET[8];
+
+/* Claves de Zobrist por (jugador, celda) para los rastros; la de la cabeza es
+ * la misma rotada. Las llena position_rehash la primera vez. */
+extern uint64_t SEARCH_ZOBRIST[MAX_PLAYERS][SEARCH_ROWS * SEARCH_STRIDE];
+
+/* Copia la ventana centrada en el jugador me. Llamar con el lock de lectura
+ * tomado. Devuelve false si me no está en el tablero. */
+bool position_snapshot(SearchPosition *pos, const GameState *state, int me);
+
+/* Recalcula pos->hash desde cero (position_snapshot ya lo hace) */
+void position_rehash(SearchPosition *pos);
+
+/* Celdas libres alcanzables desde cell (sin contarla) moviendo como rey, en
+ * region. Expande fila a fila con desplazamientos de palabra. Devuelve cuántas. */
+int position_flood(const SearchPosition *pos, int cell, uint64_t region[SEARCH_ROWS]);
+
+/* Suma de recompensas de region: un popcount por plano y fila */
+int position_region_reward(const SearchPosition *pos, const uint64_t region[SEARCH_ROWS]);
+
+static inline bool position_is_free(const SearchPosition *pos, int cell)
+{
+    return (pos->free[cell / SEARCH_STRIDE] >> (cell % SEARCH_STRIDE)) & 1u;
+}
+
+static inline int position_reward(const SearchPosition *pos, int cell)
+{
+    int row = cell / SEARCH_STRIDE, bit = cell % SEARCH_STRIDE;
+    int v = 0;
+    for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+        v |= (int)((pos->reward_plane[row][k] >> bit) & 1u) << k;
+    return v;
+}
+
+/* Vecinos libres de cell como máscara de 8 bits, bit d = dirección d */
+static inline unsigned int position_neighbours(const SearchPosition *pos, int cell)
+{
+    int row = cell / SEARCH_STRIDE, bit = cell % SEARCH_STRIDE;
+    unsigned int up = (unsigned int)(pos->free[row - 1] >> (bit - 1)) & 7u; /* bit 0 = x-1, 1 = x, 2 = x+1 */
+    unsigned int mid = (unsigned int)(pos->free[row] >> (bit - 1)) & 5u;
+    unsigned int down = (unsigned int)(pos->free[row + 1] >> (bit - 1)) & 7u;
+    return ((up >> 1) & 1u) | ((up >> 2) << 1) | ((mid >> 2) << 2) | ((down >> 2) << 3) | (((down >> 1) & 1u) << 4) |
+           ((down & 1u) << 5) | ((mid & 1u) << 6) | ((up & 1u) << 7);
+}
+
+/* Cuenta los vecinos con tres ventanas de 3 bits y una tabla de nibbles en una
+ * constante: más barato que un popcount si el objetivo no tiene la instrucción */
+static inline int position_free_neighbours(const SearchPosition *pos, int cell)
+{
+    int row = cell / SEARCH_STRIDE, shift = cell % SEARCH_STRIDE - 1;
+    unsigned int up = (unsigned int)(pos->free[row - 1] >> shift) & 7u;
+    unsigned int mid = (unsigned int)(pos->free[row] >> shift) & 5u;
+    unsigned int down = (unsigned int)(pos->free[row + 1] >> shift) & 7u;
+    return (int)(((0x32212110u >> (up * 4)) & 15u) + ((0x32212110u >> (mid * 4)) & 15u) +
+                 ((0x32212110u >> (down * 4)) & 15u));
+}
+
+/* Direcciones válidas del jugador p (a lo sumo 8). Devuelve cuántas. */
+static inline int position_moves(const SearchPosition *pos, int p, unsigned char *out)
+{
+    if (pos->head[p] == SEARCH_NO_CELL)
+        return 0;
+    unsigned int mask = position_neighbours(pos, pos->head[p]);
+    int n = 0;
+    while (mask)
+    {
+        out[n++] = (unsigned char)__builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+    return n;
+}
+
+static inline int position_mobility(const SearchPosition *pos, int p)
+{
+    return pos->head[p] == SEARCH_NO_CELL ? 0 : position_free_neighbours(pos, pos->head[p]);
+}
+
+static inline uint64_t position_head_key(int p, int cell)
+{
+    uint64_t k = SEARCH_ZOBRIST[p][cell];
+    return (k << 17) | (k >> 47);
+}
+
+/* Mueve a p en la dirección d (que debe ser válida). Devuelve la recompensa
+ * tomada, que es lo único que necesita position_unmake. */
+static inline int position_make(SearchPosition *pos, int p, unsigned char d)
+{
+    int from = pos->head[p], to = from + SEARCH_DIR_OFFSET[d];
+    uint64_t bit = (uint64_t)1 << (to % SEARCH_STRIDE);
+    int reward = position_reward(pos, to);
+    pos->free[to / SEARCH_STRIDE] &= ~bit;
+    pos->trail[p][to / SEARCH_STRIDE] |= bit;
+    pos->head[p] = to;
+    pos->score[p] += reward;
+    pos->hash ^= SEARCH_ZOBRIST[p][to] ^ position_head_key(p, from) ^ position_head_key(p, to);
+    return reward;
+}
+
+static inline void position_unmake(SearchPosition *pos, int p, unsigned char d, int reward)
+{
+    int to = pos->head[p], from = to - SEARCH_DIR_OFFSET[d];
+    uint64_t bit = (uint64_t)1 << (to % SEARCH_STRIDE);
+    pos->free[to / SEARCH_STRIDE] |= bit;
+    pos->trail[p][to / SEARCH_STRIDE] &= ~bit;
+    pos->head[p] = from;
+    pos->score[p] -= reward;
+    pos->hash ^= SEARCH_ZOBRIST[p][to] ^ position_head_key(p, from) ^ position_head_key(p, to);
+}
+
+/* Chebyshev entre dos celdas de la ventana */
+static inline int position_distance(int a, int b)
+{
+    int dx = a % SEARCH_STRIDE - b % SEARCH_STRIDE;
+    int dy = a / SEARCH_STRIDE - b / SEARCH_STRIDE;
+    dx = dx < 0 ? -dx : dx;
+    dy = dy < 0 ? -dy : dy;
+    return dx > dy ? dx : dy;
+}
+
+#endif /* SEARCH_POSITION_H */
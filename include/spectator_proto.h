@@ -0,0 +1,58 @@
+#ifndef SPECTATOR_PROTO_H
+#define SPECTATOR_PROTO_H
+
+#include <stdint.h>
+
+/* Protocolo del servidor de espectadores (Unix domain socket, stream).
+ *
+ * Cada frame es un SpectatorFrameHeader seguido de payload_len bytes, todo en
+ * el orden de bytes del host (el socket es local).
+ *
+ * Keyframe (SPECTATOR_FRAME_KEY), se envía al conectar y cuando un cliente
+ * perdió frames:
+ *   SpectatorFrameInfo, player_count x SpectatorPlayerRow,
+ *   uint32 run_count, run_count x { uint32 count; int32 value }   (RLE)
+ *
+ * Delta (SPECTATOR_FRAME_DELTA), relativo al frame de seq - 1:
+ *   SpectatorFrameInfo, player_count x SpectatorPlayerRow,
+ *   uint32 run_count, run_count x { uint32 start; uint32 count; int32 values[count] }
+ */
+
+#define SPECTATOR_DEFAULT_SOCKET "/tmp/game_spectator.sock"
+#define SPECTATOR_MAX_PLAYER_ROWS 16 /* cota de player_count para los clientes */
+#define SPECTATOR_MAX_CELLS (1u << 22) /* el protocolo envía el tablero entero */
+#define SPECTATOR_FRAME_MAGIC 0x53504543u /* "CEPS" en little-endian */
+
+enum
+{
+    SPECTATOR_FRAME_KEY = 1,
+    SPECTATOR_FRAME_DELTA = 2
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t type;
+    uint32_t seq;
+    uint32_t payload_len;
+} SpectatorFrameHeader;
+
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t player_count;
+    uint32_t finished;
+} SpectatorFrameInfo;
+
+typedef struct
+{
+    char name[16];
+    uint32_t score;
+    uint32_t valid_move_requests;
+    uint32_t invalid_move_requests;
+    uint32_t x, y;
+    uint32_t blocked;
+} SpectatorPlayerRow;
+
+#endif /* SPECTATOR_PROTO_H */
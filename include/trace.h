@@ -0,0 +1,121 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+#include "constants.h"
+
+/* Trazas de eventos con marca de tiempo, una ring por proceso en el segmento
+ * TRACE_SHM_NAME. El master lo crea con -T; cada proceso reclama su ring con
+ * trace_attach y, si el segmento no existe, las macros TRACE_* no hacen nada.
+ * Cada ring tiene un único hilo escritor, así que escribir un evento es una
+ * lectura de reloj, una copia y un store de head con release. Compilando con
+ * -DTRACE_DISABLED las macros desaparecen. */
+
+#define TRACE_SHM_NAME "/game_trace"
+#define TRACE_MAGIC 0x43525447u /* "GTRC" en little-endian */
+#define TRACE_VERSION 1
+#define TRACE_RING_EVENTS (1u << 15) /* potencia de 2 */
+#define TRACE_MAX_RINGS (MAX_PLAYERS + 4) /* master, vista, jugadores y sidecars */
+
+typedef enum
+{
+    TRACE_PIPE_READ = 0,  /* master: lectura de una solicitud */
+    TRACE_MOVE_APPLY,     /* master: aplicar un movimiento o un lote (-j) */
+    TRACE_VIEW_WAIT,      /* master: esperando view_print_done */
+    TRACE_WRITER_WAIT,    /* esperando el lock de escritor */
+    TRACE_WRITER_HELD,
+    TRACE_READER_WAIT,    /* esperando el lock de lector */
+    TRACE_READER_HELD,
+    TRACE_VIEW_RENDER,    /* vista: dibujar y volcar un frame */
+    TRACE_PLAYER_THINK,   /* jugador: decidir el próximo movimiento o plan */
+    TRACE_CREDIT_WAIT,    /* jugador: esperando player_can_move */
+    TRACE_EVENT_COUNT
+} TraceEventId;
+
+enum
+{
+    TRACE_PHASE_BEGIN = 'B',
+    TRACE_PHASE_END = 'E',
+    TRACE_PHASE_INSTANT = 'i'
+};
+
+typedef struct
+{
+    uint64_t ts_ns; /* CLOCK_MONOTONIC, común a todos los procesos */
+    uint32_t arg;
+    uint16_t event; /* TraceEventId */
+    uint8_t phase;
+    uint8_t reserved;
+} TraceEvent;
+
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t head; /* eventos escritos desde el inicio */
+    pid_t pid;
+    char name[16];
+    _Alignas(CACHE_LINE_SIZE) TraceEvent events[TRACE_RING_EVENTS];
+} TraceRing;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_count;
+    uint32_t ring_events;
+    _Atomic uint32_t rings_claimed;
+    _Alignas(CACHE_LINE_SIZE) TraceRing rings[TRACE_MAX_RINGS];
+} TraceBuffer;
+
+/* Ring del proceso (NULL = sin trazas) */
+extern TraceRing *trace_ring;
+
+/* Master: crea TRACE_SHM_NAME y reclama su ring. Devuelve false con errno. */
+bool trace_create(const char *name);
+
+/* Master: borra un segmento que haya quedado de una ejecución anterior, para
+ * que los hijos de una partida sin -T no escriban en él. */
+void trace_unlink_stale(void);
+
+/* Reclama una ring del segmento si existe; sin él, no hace nada. */
+void trace_attach(const char *name);
+
+/* Master: vuelca el segmento tal cual a path, para trace_export */
+bool trace_dump(const char *path);
+
+/* Master: cierra y elimina el segmento */
+void trace_destroy(void);
+
+const char *trace_event_name(unsigned int event);
+
+static inline void trace_emit(TraceEventId event, uint8_t phase, uint32_t arg)
+{
+    TraceRing *ring = trace_ring;
+    if (ring == NULL)
+        return;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent *e = &ring->events[head & (TRACE_RING_EVENTS - 1)];
+    e->ts_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    e->arg = arg;
+    e->event = (uint16_t)event;
+    e->phase = phase;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+#ifdef TRACE_DISABLED
+#define TRACE_BEGIN(ev) ((void)0)
+#define TRACE_END(ev) ((void)0)
+#define TRACE_INSTANT(ev, arg) ((void)0)
+#else
+#define TRACE_BEGIN(ev) trace_emit((ev), TRACE_PHASE_BEGIN, 0)
+#define TRACE_END(ev) trace_emit((ev), TRACE_PHASE_END, 0)
+#define TRACE_INSTANT(ev, arg) trace_emit((ev), TRACE_PHASE_INSTANT, (uint32_t)(arg))
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,46 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tabla de transposición compartida por los hilos de búsqueda, sin locks.
+ * Está partida en cubetas de una línea de caché con 4 entradas; cada entrada
+ * guarda la clave xor los datos junto a los datos, así que una entrada a
+ * medio escribir por otro hilo no coincide con ninguna clave y se descarta.
+ *
+ * Reemplazo: la misma posición se pisa salvo que lo guardado sea más
+ * profundo y de la búsqueda en curso; si no, se pisa la entrada de una
+ * búsqueda anterior o, entre las de ésta, la menos profunda. */
+
+#define TT_BOUND_UPPER 1 /* el valor real es <= value */
+#define TT_BOUND_LOWER 2 /* el valor real es >= value */
+#define TT_BOUND_EXACT 3
+#define TT_NO_MOVE 0xF
+
+typedef struct TranspositionCDT *TranspositionADT;
+
+typedef struct
+{
+    int value;
+    int depth;
+    int bound;
+    int move;      /* mejor dirección encontrada, o TT_NO_MOVE */
+    bool complete; /* el subárbol no se cortó por profundidad en ninguna hoja */
+} TTEntry;
+
+/* Usa a lo sumo bytes (redondeado a potencia de 2 de cubetas). Devuelve
+ * NULL con errno; con bytes menor que una cubeta, EINVAL. */
+TranspositionADT tt_create(size_t bytes);
+
+void tt_destroy(TranspositionADT tt);
+
+/* Marca el comienzo de una búsqueda: lo de antes pasa a ser reemplazable */
+void tt_new_search(TranspositionADT tt);
+
+bool tt_probe(TranspositionADT tt, uint64_t key, TTEntry *out);
+
+void tt_store(TranspositionADT tt, uint64_t key, const TTEntry *entry);
+
+#endif /* TRANSPOSITION_H */
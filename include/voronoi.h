@@ -0,0 +1,39 @@
+#ifndef VORONOI_H
+#define VORONOI_H
+
+#include "search_position.h"
+
+/* Territorio de Voronoi sobre una SearchPosition: cada celda libre es de
+ * quien llega a ella antes (en pasos de rey desde su cabeza); los empates no
+ * son de nadie. Las distancias salen de un BFS multi-fuente por frentes sobre
+ * los bitboards de fila: cada capa dilata el frente de cada jugador con
+ * desplazamientos de palabra, 64 celdas por operación.
+ *
+ * El mapa guarda las capas de la última posición evaluada. La siguiente se
+ * compara con ella y cada jugador rehace sólo desde la primera capa que toca
+ * una celda cambiada (desde el principio si movió su cabeza), así que dos
+ * hojas vecinas del árbol, o dos turnos seguidos, no pagan el BFS entero. */
+
+#define VORONOI_MAX_LAYERS 128 /* más allá, las celdas cuentan como inalcanzables */
+
+typedef struct VoronoiCDT *VoronoiADT;
+
+typedef struct
+{
+    int cells;  /* celdas libres propias */
+    int reward; /* suma de sus recompensas */
+} VoronoiShare;
+
+/* Devuelve NULL con errno */
+VoronoiADT voronoi_create(void);
+
+void voronoi_destroy(VoronoiADT v);
+
+/* Lleva el mapa a pos y reparte el territorio en share[p] para cada jugador
+ * de pos (los bloqueados o fuera de la ventana quedan en cero) */
+void voronoi_evaluate(VoronoiADT v, const SearchPosition *pos, VoronoiShare share[MAX_PLAYERS]);
+
+/* Capas de BFS recalculadas desde la creación (para medir lo incremental) */
+unsigned long long voronoi_layers_built(VoronoiADT v);
+
+#endif /* VORONOI_H */
@@ -0,0 +1,49 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/* Pool de hilos con robo de trabajo: cada hilo tiene su deque (Chase-Lev) en
+ * la que apila lo que genera y de la que saca por el fondo; los ociosos roban
+ * por el tope de la de otro. Quien espera a un grupo no se bloquea: ejecuta
+ * tareas (propias o robadas) hasta que el grupo termina, así que las tareas
+ * pueden generar subtareas y esperarlas sin agotar hilos. */
+
+typedef struct WorkPoolCDT *WorkPoolADT;
+
+typedef struct
+{
+    atomic_int pending;
+} WorkGroup;
+
+/* Se embebe al principio de la estructura de cada tarea */
+typedef struct WorkTask
+{
+    void (*run)(struct WorkTask *task);
+    WorkGroup *group;
+} WorkTask;
+
+/* threads hilos en total, contando al que llama a work_pool_wait (con 1 no se
+ * crea ninguno y las tareas corren en work_pool_wait). Devuelve NULL con errno. */
+WorkPoolADT work_pool_create(unsigned int threads);
+
+unsigned int work_pool_threads(WorkPoolADT pool);
+
+/* Índice (0 = el creador) del hilo que llama, para datos por hilo */
+unsigned int work_pool_worker_index(WorkPoolADT pool);
+
+static inline void work_group_init(WorkGroup *group)
+{
+    atomic_init(&group->pending, 0);
+}
+
+/* Encola task en la deque del hilo que llama. Si está llena la ejecuta ahí. */
+void work_pool_spawn(WorkPoolADT pool, WorkTask *task, WorkGroup *group);
+
+/* Ejecuta tareas hasta que todas las de group hayan terminado */
+void work_pool_wait(WorkPoolADT pool, WorkGroup *group);
+
+void work_pool_destroy(WorkPoolADT pool);
+
+#endif /* WORK_POOL_H */
@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+# Barrido de escalabilidad del master con jugadores loadgen.
+#
+# Recorre cantidad de jugadores, tamaño de tablero y delay, corre una partida
+# por combinación y tabula (CSV por stdout) el throughput del master y la
+# latencia de ida y vuelta medida por los loadgen.
+#
+# Uso: scripts/sweep.sh [-p "1 2 ... 9"] [-b "10x10 50x50"] [-d "0 10"]
+#                       [-D segundos_por_partida] [-r rate] [-i invalid_pct]
+#
+# Requiere los binarios compilados (make) en la raíz del repo.
+
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+PLAYER_COUNTS="1 2 3 4 5 6 7 8 9"
+BOARDS="10x10 50x50 200x200"
+DELAYS="0"
+DURATION=3
+RATE=0
+INVALID_PCT=0
+
+while getopts "p:b:d:D:r:i:" opt; do
+    case "$opt" in
+    p) PLAYER_COUNTS="$OPTARG" ;;
+    b) BOARDS="$OPTARG" ;;
+    d) DELAYS="$OPTARG" ;;
+    D) DURATION="$OPTARG" ;;
+    r) RATE="$OPTARG" ;;
+    i) INVALID_PCT="$OPTARG" ;;
+    *)
+        sed -n '2,12p' "$0" >&2
+        exit 1
+        ;;
+    esac
+done
+
+for bin in master loadgen; do
+    if [[ ! -x "./$bin" ]]; then
+        echo "sweep: ./$bin not found, run make first" >&2
+        exit 1
+    fi
+done
+
+log=$(mktemp)
+trap 'rm -f "$log"' EXIT
+
+echo "players,width,height,delay_ms,requests,valid,invalid,seconds,requests_per_s,rtt_p50_us_avg,rtt_p99_us_max"
+for board in $BOARDS; do
+    width=${board%x*}
+    height=${board#*x}
+    for delay in $DELAYS; do
+        for players in $PLAYER_COUNTS; do
+            paths=()
+            for ((i = 0; i < players; i++)); do
+                paths+=(./loadgen)
+            done
+
+            # SIGINT sólo al master (--foreground): cierra la partida de forma
+            # ordenada y los loadgen terminan al ver finished o el pipe cerrado.
+            LOADGEN_RATE="$RATE" LOADGEN_INVALID_PCT="$INVALID_PCT" \
+                timeout --foreground -s INT "$DURATION" \
+                ./master -w "$width" -h "$height" -d "$delay" -t "$DURATION" -p "${paths[@]}" >"$log" 2>&1 || true
+
+            awk -v players="$players" -v width="$width" -v height="$height" -v delay="$delay" '
+                /^Game stats:/ {
+                    requests = $3
+                    gsub(/[(]/, "", $5); valid = $5
+                    invalid = $7
+                    seconds = $10
+                    gsub(/[(]/, "", $12); rps = $12
+                }
+                /^loadgen:/ {
+                    for (f = 1; f <= NF; f++) {
+                        if ($f ~ /^p50=/) { sub(/p50=/, "", $f); p50_sum += $f; n++ }
+                        if ($f ~ /^p99=/) { sub(/p99=/, "", $f); if ($f > p99_max) p99_max = $f }
+                    }
+                }
+                END {
+                    printf "%d,%d,%d,%d,%s,%s,%s,%s,%s,%.1f,%.1f\n", players, width, height, delay,
+                           requests, valid, invalid, seconds, rps, n ? p50_sum / n : 0, p99_max
+                }' "$log"
+        done
+    done
+done
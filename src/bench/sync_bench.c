@@ -0,0 +1,327 @@
+#define _POSIX_C_SOURCE 200809L // para getopt y clock_gettime
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "game_sync.h"
+#include "shmADT.h"
+#include "sample_stats.h"
+
+// Microbenchmark del RW-lock de GameSync: N procesos lectores usan
+// game_sync_reader_enter/exit y un escritor usa el camino del master
+// (game_sync_writer_enter/exit) sobre un GameSync real en memoria compartida.
+// Emite una línea CSV por rol y configuración.
+
+#define MAX_BENCH_READERS 64
+#define MAX_LIST_LEN 16
+#define MAX_SAMPLES_PER_PROC 200000
+#define DEFAULT_DURATION_MS 1000
+#define DEFAULT_WRITER_HOLD_US 10
+#define DEFAULT_WRITER_PERIOD_US 100
+
+typedef struct
+{
+    unsigned int reader_counts[MAX_LIST_LEN];
+    int reader_counts_len;
+    unsigned int hold_us[MAX_LIST_LEN];
+    int hold_us_len;
+    unsigned int duration_ms;
+    unsigned int writer_hold_us;
+    unsigned int writer_period_us;
+} BenchArgs;
+
+// Resultados de cada proceso: el escritor ocupa el slot 0
+typedef struct
+{
+    uint64_t ops;
+    uint32_t sample_count;
+    uint32_t samples[MAX_SAMPLES_PER_PROC]; // latencia de adquisición (ns)
+} ProcResults;
+
+typedef struct
+{
+    atomic_int ready;
+    atomic_int start;
+    atomic_int stop;
+    ProcResults procs[]; // 1 escritor + readers
+} BenchShared;
+
+static inline void spin_for_us(unsigned int us)
+{
+    if (us == 0)
+        return;
+    uint64_t until = monotonic_ns() + (uint64_t)us * 1000ULL;
+    while (monotonic_ns() < until)
+        ;
+}
+
+static inline void record_sample(ProcResults *r, uint64_t latency_ns)
+{
+    r->ops++;
+    if (r->sample_count < MAX_SAMPLES_PER_PROC)
+        r->samples[r->sample_count++] = latency_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_ns;
+}
+
+static void wait_for_start(BenchShared *shared)
+{
+    atomic_fetch_add(&shared->ready, 1);
+    while (!atomic_load(&shared->start))
+        sched_yield();
+}
+
+static void run_reader(GameSync *sync, BenchShared *shared, ProcResults *r, unsigned int hold_us)
+{
+    wait_for_start(shared);
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed))
+    {
+        uint64_t t0 = monotonic_ns();
+        game_sync_reader_enter(sync);
+        uint64_t t1 = monotonic_ns();
+        spin_for_us(hold_us);
+        game_sync_reader_exit(sync);
+        record_sample(r, t1 - t0);
+    }
+}
+
+static void run_writer(GameSync *sync, BenchShared *shared, ProcResults *r, const BenchArgs *args)
+{
+    wait_for_start(shared);
+    while (!atomic_load_explicit(&shared->stop, memory_order_relaxed))
+    {
+        uint64_t t0 = monotonic_ns();
+        game_sync_writer_enter(sync);
+        uint64_t t1 = monotonic_ns();
+        spin_for_us(args->writer_hold_us);
+        game_sync_writer_exit(sync);
+        record_sample(r, t1 - t0);
+        spin_for_us(args->writer_period_us);
+    }
+}
+
+static void emit_csv(const char *role, unsigned int readers, unsigned int hold_us, double elapsed_s,
+                     const ProcResults *procs, int first, int count)
+{
+    size_t total_samples = 0;
+    uint64_t total_ops = 0;
+    for (int i = first; i < first + count; i++)
+    {
+        total_samples += procs[i].sample_count;
+        total_ops += procs[i].ops;
+    }
+
+    uint32_t *merged = malloc((total_samples ? total_samples : 1) * sizeof(uint32_t));
+    if (merged == NULL)
+    {
+        perror("sync_bench: malloc samples");
+        return;
+    }
+    size_t k = 0;
+    for (int i = first; i < first + count; i++)
+    {
+        memcpy(merged + k, procs[i].samples, procs[i].sample_count * sizeof(uint32_t));
+        k += procs[i].sample_count;
+    }
+    sample_stats_sort(merged, total_samples);
+
+    printf("%u,%u,%s,%llu,%.0f,%u,%u,%u,%u,%u\n",
+           readers, hold_us, role,
+           (unsigned long long)total_ops,
+           elapsed_s > 0 ? (double)total_ops / elapsed_s : 0.0,
+           sample_stats_percentile(merged, total_samples, 0.50),
+           sample_stats_percentile(merged, total_samples, 0.90),
+           sample_stats_percentile(merged, total_samples, 0.99),
+           sample_stats_percentile(merged, total_samples, 0.999),
+           sample_stats_percentile(merged, total_samples, 1.0));
+    fflush(stdout);
+    free(merged);
+}
+
+static bool run_config(GameSync *sync, const BenchArgs *args, unsigned int readers, unsigned int hold_us)
+{
+    int procs = 1 + (int)readers;
+    size_t shared_size = sizeof(BenchShared) + (size_t)procs * sizeof(ProcResults);
+    BenchShared *shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        perror("sync_bench: mmap results");
+        return false;
+    }
+    atomic_init(&shared->ready, 0);
+    atomic_init(&shared->start, 0);
+    atomic_init(&shared->stop, 0);
+
+    // Estado del lock como lo deja el master al arrancar
+    sem_init(&sync->master_starvation_guard, 1, 1);
+    sem_init(&sync->state_mutex, 1, 1);
+    sem_init(&sync->readers_count_mutex, 1, 1);
+    sync->readers_count = 0;
+
+    pid_t pids[1 + MAX_BENCH_READERS];
+    int launched = 0;
+    for (int i = 0; i < procs; i++)
+    {
+        pid_t pid = fork();
+        if (pid == -1)
+        {
+            perror("sync_bench: fork");
+            break;
+        }
+        if (pid == 0)
+        {
+            if (i == 0)
+                run_writer(sync, shared, &shared->procs[0], args);
+            else
+                run_reader(sync, shared, &shared->procs[i], hold_us);
+            _exit(EXIT_SUCCESS);
+        }
+        pids[launched++] = pid;
+    }
+
+    while (atomic_load(&shared->ready) < launched)
+        sched_yield();
+
+    uint64_t t0 = monotonic_ns();
+    atomic_store(&shared->start, 1);
+    struct timespec duration = {.tv_sec = args->duration_ms / 1000, .tv_nsec = (args->duration_ms % 1000) * 1000000L};
+    while (nanosleep(&duration, &duration) == -1 && errno == EINTR)
+        ;
+    atomic_store(&shared->stop, 1);
+
+    for (int i = 0; i < launched; i++)
+    {
+        waitpid(pids[i], NULL, 0);
+    }
+    double elapsed_s = (double)(monotonic_ns() - t0) / 1e9;
+
+    bool ok = launched == procs;
+    if (ok)
+    {
+        emit_csv("writer", readers, hold_us, elapsed_s, shared->procs, 0, 1);
+        emit_csv("reader", readers, hold_us, elapsed_s, shared->procs, 1, (int)readers);
+    }
+
+    sem_destroy(&sync->master_starvation_guard);
+    sem_destroy(&sync->state_mutex);
+    sem_destroy(&sync->readers_count_mutex);
+    munmap(shared, shared_size);
+    return ok;
+}
+
+static bool parse_list(const char *spec, unsigned int *out, int *out_len, unsigned int max_value)
+{
+    *out_len = 0;
+    const char *p = spec;
+    while (*p)
+    {
+        char *end;
+        unsigned long v = strtoul(p, &end, 10);
+        if (end == p || v > max_value || *out_len == MAX_LIST_LEN)
+            return false;
+        out[(*out_len)++] = (unsigned int)v;
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return false;
+        p = end;
+    }
+    return *out_len > 0;
+}
+
+static void print_usage(const char *exec_name)
+{
+    fprintf(stderr, "Usage: %s [-r readers,...] [-H hold_us,...] [-d duration_ms] [-w writer_hold_us] [-i writer_period_us]\n", exec_name);
+}
+
+static bool parse_args(int argc, char **argv, BenchArgs *args)
+{
+    *args = (BenchArgs){
+        .reader_counts = {1, 2, 4, 8},
+        .reader_counts_len = 4,
+        .hold_us = {0, 10, 100},
+        .hold_us_len = 3,
+        .duration_ms = DEFAULT_DURATION_MS,
+        .writer_hold_us = DEFAULT_WRITER_HOLD_US,
+        .writer_period_us = DEFAULT_WRITER_PERIOD_US,
+    };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:H:d:w:i:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            if (!parse_list(optarg, args->reader_counts, &args->reader_counts_len, MAX_BENCH_READERS))
+            {
+                fprintf(stderr, "sync_bench: invalid reader list '%s' (max %d readers)\n", optarg, MAX_BENCH_READERS);
+                return false;
+            }
+            break;
+        case 'H':
+            if (!parse_list(optarg, args->hold_us, &args->hold_us_len, 1000000))
+            {
+                fprintf(stderr, "sync_bench: invalid hold list '%s'\n", optarg);
+                return false;
+            }
+            break;
+        case 'd':
+            args->duration_ms = (unsigned int)atoi(optarg);
+            break;
+        case 'w':
+            args->writer_hold_us = (unsigned int)atoi(optarg);
+            break;
+        case 'i':
+            args->writer_period_us = (unsigned int)atoi(optarg);
+            break;
+        default:
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return args->duration_ms > 0;
+}
+
+int main(int argc, char **argv)
+{
+    BenchArgs args;
+    if (!parse_args(argc, argv, &args))
+        return EXIT_FAILURE;
+
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "/game_sync_bench_%d", (int)getpid());
+    ShmADT sync_shm = create_shm(shm_name, sizeof(GameSync), O_RDWR | O_CREAT | O_EXCL, 0600, PROT_READ | PROT_WRITE);
+    if (sync_shm == NULL)
+    {
+        perror("sync_bench: create_shm GameSync failed");
+        return EXIT_FAILURE;
+    }
+    GameSync *sync = get_shm_pointer(sync_shm);
+
+    printf("readers,hold_us,role,ops,ops_per_s,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+    int ret = EXIT_SUCCESS;
+    for (int r = 0; r < args.reader_counts_len && ret == EXIT_SUCCESS; r++)
+    {
+        for (int h = 0; h < args.hold_us_len; h++)
+        {
+            if (!run_config(sync, &args, args.reader_counts[r], args.hold_us[h]))
+            {
+                ret = EXIT_FAILURE;
+                break;
+            }
+        }
+    }
+
+    destroy_shm(sync_shm);
+    return ret;
+}
@@ -0,0 +1,258 @@
+#define _POSIX_C_SOURCE 200809L // para getopt
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "board_file.h"
+#include "constants.h"
+
+// Genera y convierte archivos de tablero (board_file.h) para `master -b`.
+//
+// El tablero sale de una de estas fuentes:
+//   -w/-h/-s      srand(seed) + rand() en orden de fila, como init_game_state:
+//                 el mismo tablero que `master -s seed` con la misma libc
+//   -w/-h/-s -g   board_procedural_reward, el de `master -g -s seed`
+//   -i file.bin   un archivo de tablero existente (un volcado de -B, por ejemplo)
+//   -f file.txt   texto: "width height" y después height filas de width enteros
+//
+// y se escribe con -o (binario) y/o -x (texto, "-" para stdout). Siempre se
+// imprime un resumen con el checksum, que identifica el mapa.
+
+typedef struct
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int seed;
+    bool procedural;
+    const char *input_path; // -i
+    const char *text_path;  // -f
+    const char *output_path; // -o
+    const char *text_output_path; // -x
+} ToolArgs;
+
+typedef struct
+{
+    unsigned int width;
+    unsigned int height;
+    int8_t *cells;
+} Board;
+
+static void print_usage(const char *exec_name)
+{
+    fprintf(stderr,
+            "Usage: %s [-w width -h height [-s seed] [-g] | -i board.bin | -f board.txt] [-o board.bin] [-x board.txt|-]\n",
+            exec_name);
+}
+
+static bool parse_args(int argc, char **argv, ToolArgs *args)
+{
+    *args = (ToolArgs){.width = DEFAULT_WIDTH, .height = DEFAULT_HEIGHT, .seed = (unsigned int)time(NULL)};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:s:gi:f:o:x:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            args->width = atoi(optarg);
+            break;
+        case 'h':
+            args->height = atoi(optarg);
+            break;
+        case 's':
+            args->seed = atoi(optarg);
+            break;
+        case 'g':
+            args->procedural = true;
+            break;
+        case 'i':
+            args->input_path = optarg;
+            break;
+        case 'f':
+            args->text_path = optarg;
+            break;
+        case 'o':
+            args->output_path = optarg;
+            break;
+        case 'x':
+            args->text_output_path = optarg;
+            break;
+        default:
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (optind < argc || (args->input_path && args->text_path))
+    {
+        print_usage(argv[0]);
+        return false;
+    }
+    if (!args->input_path && !args->text_path &&
+        (args->width < MIN_WIDTH || args->height < MIN_HEIGHT || args->width > MAX_WIDTH || args->height > MAX_HEIGHT))
+    {
+        fprintf(stderr, "Error: Width and height must be between %d and %u.\n", MIN_WIDTH, MAX_WIDTH);
+        return false;
+    }
+    return true;
+}
+
+static bool alloc_board(Board *board, unsigned int width, unsigned int height)
+{
+    board->width = width;
+    board->height = height;
+    board->cells = malloc((size_t)width * height);
+    if (board->cells == NULL)
+    {
+        fprintf(stderr, "boardtool: out of memory for a %ux%u board\n", width, height);
+        return false;
+    }
+    return true;
+}
+
+static bool generate_board(const ToolArgs *args, Board *board)
+{
+    if (!alloc_board(board, args->width, args->height))
+        return false;
+    srand(args->seed);
+    for (unsigned int y = 0; y < board->height; y++)
+    {
+        int8_t *row = board->cells + (size_t)y * board->width;
+        for (unsigned int x = 0; x < board->width; x++)
+            row[x] = (int8_t)(args->procedural ? board_procedural_reward(args->seed, x, y) : 1 + (rand() % 9));
+    }
+    return true;
+}
+
+static bool read_binary(const char *path, Board *board)
+{
+    BoardFileADT bf = board_file_open(path);
+    if (bf == NULL)
+        return false;
+    bool ok = alloc_board(board, board_file_width(bf), board_file_height(bf));
+    if (ok)
+        memcpy(board->cells, board_file_cells(bf), (size_t)board->width * board->height);
+    board_file_close(bf);
+    return ok;
+}
+
+static bool read_text(const char *path, Board *board)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        fprintf(stderr, "boardtool: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    unsigned int width, height;
+    if (fscanf(f, "%u %u", &width, &height) != 2 || width == 0 || height == 0 || width > MAX_WIDTH ||
+        height > MAX_HEIGHT)
+    {
+        fprintf(stderr, "boardtool: %s: expected \"width height\" on the first line\n", path);
+        fclose(f);
+        return false;
+    }
+    if (!alloc_board(board, width, height))
+    {
+        fclose(f);
+        return false;
+    }
+    size_t count = (size_t)width * height;
+    for (size_t i = 0; i < count; i++)
+    {
+        int value;
+        if (fscanf(f, "%d", &value) != 1 || !board_file_cell_valid(value))
+        {
+            fprintf(stderr, "boardtool: %s: cell (%zu, %zu) is missing or out of range (1..9 or -%d..0)\n", path,
+                    i % width, i / width, MAX_PLAYERS - 1);
+            fclose(f);
+            free(board->cells);
+            return false;
+        }
+        board->cells[i] = (int8_t)value;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool write_text(const char *path, const Board *board)
+{
+    bool to_stdout = strcmp(path, "-") == 0;
+    FILE *f = to_stdout ? stdout : fopen(path, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "boardtool: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    fprintf(f, "%u %u\n", board->width, board->height);
+    for (unsigned int y = 0; y < board->height; y++)
+    {
+        const int8_t *row = board->cells + (size_t)y * board->width;
+        for (unsigned int x = 0; x < board->width; x++)
+            fprintf(f, x + 1 < board->width ? "%d " : "%d\n", row[x]);
+    }
+    bool ok = fflush(f) == 0 && !ferror(f);
+    if (!to_stdout && fclose(f) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "boardtool: writing %s failed: %s\n", path, strerror(errno));
+    return ok;
+}
+
+static void print_summary(FILE *out, const Board *board)
+{
+    unsigned long long histogram[10] = {0};
+    unsigned long long trails = 0;
+    size_t count = (size_t)board->width * board->height;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (board->cells[i] > 0)
+            histogram[board->cells[i]]++;
+        else
+            trails++;
+    }
+    unsigned long long rewards = 0;
+    for (int v = 1; v <= 9; v++)
+        rewards += histogram[v] * (unsigned long long)v;
+    fprintf(out, "board: %ux%u, checksum %016llx\n", board->width, board->height,
+            (unsigned long long)board_file_hash(board->cells, board->width, board->height));
+    fprintf(out, "reward total: %llu, occupied cells: %llu\n", rewards, trails);
+    fprintf(out, "cells by reward:");
+    for (int v = 1; v <= 9; v++)
+        fprintf(out, " %d:%llu", v, histogram[v]);
+    fprintf(out, "\n");
+}
+
+int main(int argc, char **argv)
+{
+    ToolArgs args;
+    if (!parse_args(argc, argv, &args))
+        return EXIT_FAILURE;
+
+    Board board;
+    bool ok;
+    if (args.input_path)
+        ok = read_binary(args.input_path, &board);
+    else if (args.text_path)
+        ok = read_text(args.text_path, &board);
+    else
+        ok = generate_board(&args, &board);
+    if (!ok)
+        return EXIT_FAILURE;
+
+    if (args.output_path)
+        ok = board_file_write(args.output_path, board.width, board.height, board.cells);
+    if (ok && args.text_output_path)
+        ok = write_text(args.text_output_path, &board);
+    // Con el texto en stdout, el resumen no se mezcla con el tablero
+    bool text_on_stdout = args.text_output_path && strcmp(args.text_output_path, "-") == 0;
+    if (ok)
+        print_summary(text_on_stdout ? stderr : stdout, &board);
+
+    free(board.cells);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,306 @@
+#define _POSIX_C_SOURCE 200809L // para clock_gettime
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "endgame.h"
+#include "sample_stats.h"
+
+#define MEMO_BITS 18 // estados explorados recordados (16 bytes cada uno)
+#define TIME_CHECK_MASK 1023
+
+// Un estado es (celdas sin visitar, celda actual): con eso queda fijo también
+// lo ya ganado, así que un estado explorado no hace falta volver a verlo
+typedef struct
+{
+    uint64_t avail;
+    int cur;
+    unsigned int stamp; // de qué resolución es; las viejas no valen
+} MemoSlot;
+
+struct EndgameCDT
+{
+    // La región, indexada 0..n-1 para trabajar con máscaras de 64 bits
+    int n;
+    int cell[ENDGAME_EXACT_CELLS];
+    int reward[ENDGAME_EXACT_CELLS];
+    uint64_t adj[ENDGAME_EXACT_CELLS];
+    uint64_t start; // celdas de la región vecinas de la cabeza
+    uint64_t plane[SEARCH_REWARD_PLANES];
+    short index[SEARCH_ROWS * SEARCH_STRIDE];
+
+    // Búsqueda en curso
+    uint64_t nodes;
+    uint64_t deadline_ns;
+    bool out_of_time;
+    int best_value, best_len;
+    unsigned char path[ENDGAME_EXACT_CELLS];
+    unsigned char best_path[ENDGAME_EXACT_CELLS];
+    unsigned int stamp;
+    MemoSlot memo[1u << MEMO_BITS];
+    SearchPosition scratch;
+};
+
+EndgameADT endgame_create(void)
+{
+    struct EndgameCDT *eg = malloc(sizeof(*eg));
+    if (eg == NULL)
+        return NULL;
+    memset(eg->memo, 0, sizeof(eg->memo));
+    eg->stamp = 0;
+    return eg;
+}
+
+void endgame_destroy(EndgameADT eg)
+{
+    free(eg);
+}
+
+// Sellada: ningún rival vivo toca la región y la región no toca un borde de
+// la ventana detrás del cual el tablero sigue
+static bool is_sealed(const SearchPosition *pos, const uint64_t region[SEARCH_ROWS])
+{
+    for (int p = 0; p < pos->player_count; p++)
+    {
+        int head = pos->head[p];
+        if (p == pos->me || head == SEARCH_NO_CELL)
+            continue;
+        int row = head / SEARCH_STRIDE, bit = head % SEARCH_STRIDE;
+        if ((region[row - 1] | region[row] | region[row + 1]) & ((uint64_t)7 << (bit - 1)))
+            return false;
+    }
+    if (((pos->open_edges & SEARCH_EDGE_TOP) && region[1]) ||
+        ((pos->open_edges & SEARCH_EDGE_BOTTOM) && region[pos->height]))
+        return false;
+    uint64_t columns = 0;
+    for (int y = 1; y <= pos->height; y++)
+        columns |= region[y];
+    if (((pos->open_edges & SEARCH_EDGE_LEFT) && (columns & 2u)) ||
+        ((pos->open_edges & SEARCH_EDGE_RIGHT) && (columns >> pos->width) & 1u))
+        return false;
+    return true;
+}
+
+static bool index_region(struct EndgameCDT *eg, const SearchPosition *pos, const uint64_t region[SEARCH_ROWS])
+{
+    eg->n = 0;
+    for (int y = 1; y < SEARCH_ROWS - 1; y++)
+    {
+        uint64_t bits = region[y];
+        while (bits)
+        {
+            if (eg->n == ENDGAME_EXACT_CELLS)
+                return false;
+            int cell = y * SEARCH_STRIDE + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            eg->index[cell] = (short)eg->n;
+            eg->cell[eg->n] = cell;
+            eg->reward[eg->n] = position_reward(pos, cell);
+            eg->n++;
+        }
+    }
+
+    memset(eg->plane, 0, sizeof(eg->plane));
+    eg->start = 0;
+    int head = pos->head[pos->me];
+    for (int i = 0; i < eg->n; i++)
+    {
+        int cell = eg->cell[i];
+        eg->adj[i] = 0;
+        for (int d = 0; d < 8; d++)
+        {
+            int nb = cell + SEARCH_DIR_OFFSET[d];
+            if ((region[nb / SEARCH_STRIDE] >> (nb % SEARCH_STRIDE)) & 1u)
+                eg->adj[i] |= (uint64_t)1 << eg->index[nb];
+            else if (nb == head)
+                eg->start |= (uint64_t)1 << i;
+        }
+        for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+            if ((eg->reward[i] >> k) & 1)
+                eg->plane[k] |= (uint64_t)1 << i;
+    }
+    return true;
+}
+
+static inline int mask_reward(const struct EndgameCDT *eg, uint64_t mask)
+{
+    int sum = 0;
+    for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+        sum += __builtin_popcountll(mask & eg->plane[k]) << k;
+    return sum;
+}
+
+// Lo que se puede alcanzar desde from sin pisar celdas fuera de avail
+static uint64_t reachable(const struct EndgameCDT *eg, uint64_t from, uint64_t avail)
+{
+    uint64_t seen = from & avail, frontier = seen;
+    while (frontier)
+    {
+        uint64_t next = 0;
+        while (frontier)
+        {
+            next |= eg->adj[__builtin_ctzll(frontier)];
+            frontier &= frontier - 1;
+        }
+        frontier = next & avail & ~seen;
+        seen |= frontier;
+    }
+    return seen;
+}
+
+// true si el estado ya se exploró; si no, lo anota
+static bool memo_seen(struct EndgameCDT *eg, uint64_t avail, int cur)
+{
+    uint64_t h = (avail ^ (uint64_t)(cur + 1) * 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+    MemoSlot *slot = &eg->memo[h >> (64 - MEMO_BITS)];
+    if (slot->stamp == eg->stamp && slot->avail == avail && slot->cur == cur)
+        return true;
+    *slot = (MemoSlot){.avail = avail, .cur = cur, .stamp = eg->stamp};
+    return false;
+}
+
+static void dfs(struct EndgameCDT *eg, int cur, uint64_t avail, int value, int depth)
+{
+    if ((++eg->nodes & TIME_CHECK_MASK) == 0 && monotonic_ns() >= eg->deadline_ns)
+        eg->out_of_time = true;
+    if (eg->out_of_time)
+        return;
+    if (value > eg->best_value)
+    {
+        eg->best_value = value;
+        eg->best_len = depth;
+        memcpy(eg->best_path, eg->path, (size_t)depth);
+    }
+    uint64_t options = (cur < 0 ? eg->start : eg->adj[cur]) & avail;
+    if (options == 0 || value + mask_reward(eg, reachable(eg, options, avail)) <= eg->best_value)
+        return;
+    if (memo_seen(eg, avail, cur))
+        return;
+
+    // Primero la de menos salidas (Warnsdorff) y, a igualdad, la más valiosa
+    int order[ENDGAME_EXACT_CELLS], keys[ENDGAME_EXACT_CELLS], n = 0;
+    while (options)
+    {
+        int i = __builtin_ctzll(options);
+        options &= options - 1;
+        int key = __builtin_popcountll(eg->adj[i] & avail) * 16 - eg->reward[i];
+        int j = n++;
+        for (; j > 0 && keys[j - 1] > key; j--)
+        {
+            keys[j] = keys[j - 1];
+            order[j] = order[j - 1];
+        }
+        keys[j] = key;
+        order[j] = i;
+    }
+    for (int k = 0; k < n && !eg->out_of_time; k++)
+    {
+        int i = order[k];
+        eg->path[depth] = (unsigned char)i;
+        dfs(eg, i, avail & ~((uint64_t)1 << i), value + eg->reward[i], depth + 1);
+    }
+}
+
+static int direction_to(int from, int to)
+{
+    for (int d = 0; d < 8; d++)
+        if (from + SEARCH_DIR_OFFSET[d] == to)
+            return d;
+    return -1;
+}
+
+static void append_step(EndgamePlan *plan, const SearchPosition *pos, int from, int to)
+{
+    plan->moves[plan->len] = (unsigned char)direction_to(from, to);
+    plan->x[plan->len] = pos->x0 + to % SEARCH_STRIDE - 1;
+    plan->y[plan->len] = pos->y0 + to / SEARCH_STRIDE - 1;
+    plan->len++;
+}
+
+// Camino goloso sobre los bitboards: la celda que deja más recompensa
+// alcanzable (contando la propia), después la de menos salidas
+static void greedy_plan(struct EndgameCDT *eg, const SearchPosition *pos, EndgamePlan *plan)
+{
+    SearchPosition *work = &eg->scratch;
+    *work = *pos;
+    int me = pos->me;
+    plan->len = 0;
+    plan->value = 0;
+    while (plan->len < ENDGAME_MAX_PLAN)
+    {
+        unsigned char moves[8];
+        int n = position_moves(work, me, moves);
+        if (n == 0)
+            break;
+        int best = -1, best_reach = -1, best_exits = 0, best_reward = 0;
+        for (int i = 0; i < n; i++)
+        {
+            uint64_t region[SEARCH_ROWS];
+            int reward = position_make(work, me, moves[i]);
+            position_flood(work, work->head[me], region);
+            int reach = reward + position_region_reward(work, region);
+            int exits = position_free_neighbours(work, work->head[me]);
+            position_unmake(work, me, moves[i], reward);
+            if (reach > best_reach || (reach == best_reach && (exits < best_exits ||
+                                                               (exits == best_exits && reward > best_reward))))
+            {
+                best = i;
+                best_reach = reach;
+                best_exits = exits;
+                best_reward = reward;
+            }
+        }
+        int from = work->head[me];
+        plan->value += position_make(work, me, moves[best]);
+        append_step(plan, pos, from, work->head[me]);
+    }
+}
+
+bool endgame_solve(EndgameADT eg, const SearchPosition *pos, unsigned int budget_ms, EndgamePlan *plan)
+{
+    int head = pos->head[pos->me];
+    if (head == SEARCH_NO_CELL)
+        return false;
+    uint64_t region[SEARCH_ROWS];
+    int cells = position_flood(pos, head, region);
+    if (cells == 0 || !is_sealed(pos, region))
+        return false;
+
+    plan->cells = cells;
+    plan->exact = false;
+    if (index_region(eg, pos, region))
+    {
+        eg->stamp++;
+        eg->nodes = 0;
+        eg->deadline_ns = monotonic_ns() + (uint64_t)budget_ms * 1000000ull;
+        eg->out_of_time = false;
+        eg->best_value = -1;
+        eg->best_len = 0;
+        uint64_t all = eg->n == 64 ? ~(uint64_t)0 : ((uint64_t)1 << eg->n) - 1;
+        dfs(eg, -1, all, 0, 0);
+
+        plan->exact = !eg->out_of_time;
+        plan->value = eg->best_value;
+        plan->len = 0;
+        int from = head;
+        for (int k = 0; k < eg->best_len; k++)
+        {
+            int to = eg->cell[eg->best_path[k]];
+            append_step(plan, pos, from, to);
+            from = to;
+        }
+        if (plan->exact)
+            return true;
+    }
+
+    // Región grande o sin tiempo: el goloso, si mejora lo que haya
+    EndgamePlan greedy;
+    greedy_plan(eg, pos, &greedy);
+    if (cells > ENDGAME_EXACT_CELLS || greedy.value > plan->value)
+    {
+        greedy.cells = cells;
+        greedy.exact = false;
+        *plan = greedy;
+    }
+    return plan->len > 0;
+}
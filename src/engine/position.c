@@ -0,0 +1,189 @@
+#include <pthread.h>
+
+#include "board.h"
+#include "search_position.h"
+
+const int SEARCH_DIR_OFFSET[8] = {
+    -SEARCH_STRIDE, -SEARCH_STRIDE + 1, 1, SEARCH_STRIDE + 1,
+    SEARCH_STRIDE,  SEARCH_STRIDE - 1,  -1, -SEARCH_STRIDE - 1,
+};
+
+uint64_t SEARCH_ZOBRIST[MAX_PLAYERS][SEARCH_ROWS * SEARCH_STRIDE];
+static pthread_once_t zobrist_once = PTHREAD_ONCE_INIT;
+
+// Semilla fija: los hashes son los mismos en todas las corridas
+static void zobrist_init(void)
+{
+    uint64_t x = 0x5EA2C4B0A1D3E5F7ull;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        for (int c = 0; c < SEARCH_ROWS * SEARCH_STRIDE; c++)
+        {
+            // splitmix64
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            SEARCH_ZOBRIST[p][c] = z ^ (z >> 31);
+        }
+    }
+}
+
+void position_rehash(SearchPosition *pos)
+{
+    pthread_once(&zobrist_once, zobrist_init);
+    uint64_t h = 0;
+    for (int p = 0; p < pos->player_count; p++)
+    {
+        for (int y = 1; y < SEARCH_ROWS - 1; y++)
+        {
+            uint64_t bits = pos->trail[p][y];
+            while (bits)
+            {
+                h ^= SEARCH_ZOBRIST[p][y * SEARCH_STRIDE + __builtin_ctzll(bits)];
+                bits &= bits - 1;
+            }
+        }
+        if (pos->head[p] != SEARCH_NO_CELL)
+            h ^= position_head_key(p, pos->head[p]);
+    }
+    pos->hash = h;
+}
+
+static int window_origin(int center, int side, int board)
+{
+    int origin = center - side / 2;
+    if (origin + side > board)
+        origin = board - side;
+    return origin < 0 ? 0 : origin;
+}
+
+bool position_snapshot(SearchPosition *pos, const GameState *state, int me)
+{
+    const Player *self = &state->players[me];
+    if (self->x >= state->width || self->y >= state->height)
+        return false;
+
+    pos->width = state->width < SEARCH_WINDOW ? (int)state->width : SEARCH_WINDOW;
+    pos->height = state->height < SEARCH_WINDOW ? (int)state->height : SEARCH_WINDOW;
+    pos->x0 = window_origin((int)self->x, pos->width, (int)state->width);
+    pos->y0 = window_origin((int)self->y, pos->height, (int)state->height);
+    pos->open_edges = (pos->y0 > 0 ? SEARCH_EDGE_TOP : 0) | (pos->x0 > 0 ? SEARCH_EDGE_LEFT : 0) |
+                      ((unsigned int)(pos->x0 + pos->width) < state->width ? SEARCH_EDGE_RIGHT : 0) |
+                      ((unsigned int)(pos->y0 + pos->height) < state->height ? SEARCH_EDGE_BOTTOM : 0);
+    pos->player_count = state->player_count < MAX_PLAYERS ? (int)state->player_count : MAX_PLAYERS;
+    pos->me = me;
+
+    // Lo que quede fuera de la ventana no está libre: muro
+    memset(pos->free, 0, sizeof(pos->free));
+    memset(pos->reward_plane, 0, sizeof(pos->reward_plane));
+    memset(pos->trail, 0, sizeof(pos->trail));
+    for (int y = 0; y < pos->height; y++)
+    {
+        int row = y + 1;
+        for (int x = 0; x < pos->width; x++)
+        {
+            uint64_t bit = (uint64_t)1 << (x + 1);
+            int v = board_get(state, (unsigned int)(pos->x0 + x), (unsigned int)(pos->y0 + y));
+            if (v > 0)
+            {
+                pos->free[row] |= bit;
+                for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+                    if ((v >> k) & 1)
+                        pos->reward_plane[row][k] |= bit;
+            }
+            else if (v > -pos->player_count)
+            {
+                pos->trail[-v][row] |= bit;
+            }
+        }
+    }
+
+    for (int p = 0; p < pos->player_count; p++)
+    {
+        const Player *pl = &state->players[p];
+        int wx = (int)pl->x - pos->x0;
+        int wy = (int)pl->y - pos->y0;
+        pos->score[p] = (int)pl->score;
+        pos->head[p] = SEARCH_NO_CELL;
+        if ((p == me || !pl->blocked) && wx >= 0 && wy >= 0 && wx < pos->width && wy < pos->height)
+            pos->head[p] = (wy + 1) * SEARCH_STRIDE + wx + 1;
+    }
+    for (int p = pos->player_count; p < MAX_PLAYERS; p++)
+    {
+        pos->head[p] = SEARCH_NO_CELL;
+        pos->score[p] = 0;
+    }
+    position_rehash(pos);
+    return true;
+}
+
+static inline uint64_t dilate(uint64_t row)
+{
+    return row | (row << 1) | (row >> 1);
+}
+
+// Extiende g por los tramos contiguos de p en la fila, en los dos sentidos, con
+// desplazamientos que se duplican (6 pasos por sentido para 64 bits)
+static inline uint64_t fill_row(uint64_t g, uint64_t p)
+{
+    uint64_t l = g, lp = p, r = g, rp = p;
+    for (int shift = 1; shift < 64; shift <<= 1)
+    {
+        l |= lp & (l << shift);
+        lp &= lp << shift;
+        r |= rp & (r >> shift);
+        rp &= rp >> shift;
+    }
+    return l | r;
+}
+
+int position_flood(const SearchPosition *pos, int cell, uint64_t region[SEARCH_ROWS])
+{
+    memset(region, 0, SEARCH_ROWS * sizeof(uint64_t));
+    int seed_row = cell / SEARCH_STRIDE;
+    uint64_t seed_bit = (uint64_t)1 << (cell % SEARCH_STRIDE);
+    region[seed_row] = seed_bit;
+
+    // Barridos alternados hacia abajo y hacia arriba hasta el punto fijo. Cada
+    // fila toma lo que le llega de las vecinas y lo extiende por toda la fila,
+    // así que sólo hacen falta tantos barridos como cambios de sentido vertical
+    int lo = seed_row, hi = seed_row;
+    bool changed = true;
+    for (int pass = 0; changed; pass++)
+    {
+        changed = false;
+        int from = lo > 1 ? lo - 1 : 1, to = hi < SEARCH_ROWS - 2 ? hi + 1 : SEARCH_ROWS - 2;
+        for (int i = 0; i <= to - from; i++)
+        {
+            int y = (pass & 1) ? to - i : from + i;
+            uint64_t reached = region[y] | ((dilate(region[y - 1]) | dilate(region[y + 1])) & pos->free[y]);
+            uint64_t next = fill_row(reached, pos->free[y]);
+            if (next != region[y])
+            {
+                region[y] = next;
+                changed = true;
+                lo = y < lo ? y : lo;
+                hi = y > hi ? y : hi;
+            }
+        }
+    }
+    region[seed_row] &= ~seed_bit | pos->free[seed_row];
+
+    int count = 0;
+    for (int y = lo; y <= hi; y++)
+        count += __builtin_popcountll(region[y]);
+    return count;
+}
+
+int position_region_reward(const SearchPosition *pos, const uint64_t region[SEARCH_ROWS])
+{
+    int sum = 0;
+    for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+    {
+        int bits = 0;
+        for (int y = 1; y < SEARCH_ROWS - 1; y++)
+            bits += __builtin_popcountll(region[y] & pos->reward_plane[y][k]);
+        sum += bits << k;
+    }
+    return sum;
+}
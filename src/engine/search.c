@@ -0,0 +1,736 @@
+#define _POSIX_C_SOURCE 200809L // para clock_gettime
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sample_stats.h"
+#include "search.h"
+#include "transposition.h"
+#include "voronoi.h"
+#include "work_pool.h"
+
+// Pesos de la evaluación: la diferencia de puntaje manda, después la
+// recompensa del territorio de Voronoi (que todavía hay que ir a buscar) y la
+// movilidad desempata. El encierro propio se castiga aparte porque no tiene
+// vuelta.
+#define SCORE_WEIGHT 16
+#define TERRITORY_WEIGHT 8
+#define MOBILITY_WEIGHT 4
+#define STUCK_PENALTY 256
+#define VALUE_INF 1000000000
+#define TIME_CHECK_MASK 127 // consultar el reloj cada 128 nodos (las hojas cuentan: son las caras)
+#define NO_MOVE 0xFF
+// Profundidad restante mínima para repartir un nodo: más abajo el subárbol
+// cuesta menos que robarlo
+#define SPLIT_MIN_DEPTH 3
+
+// Datos de cada hilo del pool
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) uint64_t nodes;
+    uint64_t tt_hits;
+    bool depth_limited; // alguna hoja con movimientos se cortó por profundidad
+    unsigned char killers[SEARCH_MAX_PLY][2];
+    VoronoiADT voronoi; // sigue a las hojas de este hilo: de una a la otra cambia poco
+} WorkerState;
+
+typedef struct RootTask RootTask;
+
+// Una respuesta (capa 1) a un movimiento raíz
+typedef struct
+{
+    WorkTask task; // primero: la tarea se convierte en ChildTask con un cast
+    RootTask *parent;
+    unsigned char move;
+    SearchPosition pos;
+} ChildTask;
+
+struct RootTask
+{
+    WorkTask task;
+    struct SearchEngineCDT *engine;
+    unsigned char move;
+    int depth;
+    int mover;        // quien responde en la capa 1
+    bool maximise;    // la capa 1 es propia (no hay rivales cerca)
+    atomic_int bound; // mejor valor de la capa 1 hasta ahora: máx o mín según maximise
+    atomic_bool refuted; // ya no puede superar a la raíz: las hermanas abortan
+    SearchPosition pos;
+    ChildTask children[8];
+};
+
+// Banderas que anulan una búsqueda: la de cada punto de división por el que
+// se llegó, hasta la del movimiento raíz
+typedef struct CancelLink
+{
+    const atomic_bool *flag;
+    const struct CancelLink *up;
+} CancelLink;
+
+typedef struct SplitPoint SplitPoint;
+
+// Un hermano menor de un nodo repartido
+typedef struct
+{
+    WorkTask task;
+    SplitPoint *sp;
+    unsigned char move;
+    bool done;    // llegó a un valor sin que lo anularan
+    bool limited; // su subárbol tuvo cortes por profundidad
+    int value;
+} SplitTask;
+
+// Nodo que, resuelto el primer hijo en serie, reparte el resto (young
+// brothers wait). Las tareas copian la posición del nodo, que no cambia
+// mientras su dueño espera.
+struct SplitPoint
+{
+    struct SearchEngineCDT *engine;
+    const SearchPosition *pos;
+    CancelLink link; // anula a las tareas: su bandera es cutoff
+    int depth;
+    int ply;
+    int mover;
+    bool maximise;
+    atomic_int alpha;
+    atomic_int beta;
+    atomic_bool cutoff;
+    SplitTask tasks[8];
+};
+
+struct SearchEngineCDT
+{
+    SearchConfig cfg;
+    WorkPoolADT pool;
+    WorkerState *workers;
+    TranspositionADT tt; // NULL = sin tabla
+    uint64_t side_key[MAX_PLAYERS]; // por turno dentro de la ronda
+    // Búsqueda en curso
+    const SearchPosition *root;
+    int movers[MAX_PLAYERS]; // orden de turnos: el propio primero
+    int mover_count;
+    uint64_t salt; // ventana y jugadores que mueven: otra búsqueda, otras claves
+    uint64_t deadline_ns;
+    atomic_bool stop;
+    // Tabla compartida de la raíz: (valor, movimiento) empaquetados, sólo crece
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t best;
+    RootTask roots[8];
+};
+
+// Lo que necesita alphabeta: el tablero de la tarea y el hilo que la corre
+typedef struct
+{
+    struct SearchEngineCDT *engine;
+    WorkerState *worker;
+    SearchPosition *pos;
+    const CancelLink *cancel; // NULL = sin hermanas que puedan refutar
+} SearchContext;
+
+static unsigned long env_ulong(const char *name, unsigned long fallback)
+{
+    const char *v = getenv(name);
+    if (v == NULL || *v == '\0')
+        return fallback;
+    return strtoul(v, NULL, 10);
+}
+
+void search_config_from_env(SearchConfig *cfg)
+{
+    cfg->budget_ms = (unsigned int)env_ulong("SEARCH_BUDGET_MS", SEARCH_DEFAULT_BUDGET_MS);
+    unsigned long depth = env_ulong("SEARCH_MAX_DEPTH", SEARCH_MAX_PLY);
+    cfg->max_depth = depth < 1 ? 1 : (depth > SEARCH_MAX_PLY ? SEARCH_MAX_PLY : (unsigned int)depth);
+    unsigned long threads = env_ulong("SEARCH_THREADS", 1);
+    cfg->threads = threads < 1 ? 1 : (threads > SEARCH_MAX_THREADS ? SEARCH_MAX_THREADS : (unsigned int)threads);
+    cfg->tt_mb = (unsigned int)env_ulong("SEARCH_TT_MB", SEARCH_DEFAULT_TT_MB);
+}
+
+static uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t pack_best(int value, int move)
+{
+    return ((uint64_t)(uint32_t)(value + VALUE_INF) << 8) | (uint8_t)move;
+}
+
+static inline int best_value(uint64_t packed)
+{
+    return (int)(uint32_t)(packed >> 8) - VALUE_INF;
+}
+
+static inline int root_alpha(struct SearchEngineCDT *e)
+{
+    return best_value(atomic_load_explicit(&e->best, memory_order_relaxed));
+}
+
+static void publish_best(struct SearchEngineCDT *e, int value, int move)
+{
+    uint64_t cur = atomic_load(&e->best);
+    while (best_value(cur) < value && !atomic_compare_exchange_weak(&e->best, &cur, pack_best(value, move)))
+        ;
+}
+
+static inline bool aborted(const SearchContext *ctx)
+{
+    if (atomic_load_explicit(&ctx->engine->stop, memory_order_relaxed))
+        return true;
+    for (const CancelLink *l = ctx->cancel; l != NULL; l = l->up)
+        if (atomic_load_explicit(l->flag, memory_order_relaxed))
+            return true;
+    return false;
+}
+
+static void raise_bound(atomic_int *bound, int v)
+{
+    int cur = atomic_load(bound);
+    while (v > cur && !atomic_compare_exchange_weak(bound, &cur, v))
+        ;
+}
+
+static void lower_bound(atomic_int *bound, int v)
+{
+    int cur = atomic_load(bound);
+    while (v < cur && !atomic_compare_exchange_weak(bound, &cur, v))
+        ;
+}
+
+static int evaluate(const SearchContext *ctx)
+{
+    const SearchPosition *pos = ctx->pos;
+    const struct SearchEngineCDT *e = ctx->engine;
+    VoronoiShare share[MAX_PLAYERS];
+    voronoi_evaluate(ctx->worker->voronoi, pos, share);
+
+    int me = pos->me;
+    int opp_value = 0, opp_mobility = 0;
+    for (int i = 1; i < e->mover_count; i++)
+    {
+        int p = e->movers[i];
+        int v = pos->score[p] * SCORE_WEIGHT + share[p].reward * TERRITORY_WEIGHT;
+        if (i == 1 || v > opp_value)
+            opp_value = v;
+        int m = position_mobility(pos, p);
+        if (m > opp_mobility)
+            opp_mobility = m;
+    }
+    int mobility = position_mobility(pos, me);
+    int value = pos->score[me] * SCORE_WEIGHT + share[me].reward * TERRITORY_WEIGHT - opp_value +
+                (mobility - opp_mobility) * MOBILITY_WEIGHT;
+    return mobility == 0 ? value - STUCK_PENALTY : value;
+}
+
+// Primero el de la tabla, después los killer de la capa y el resto por
+// recompensa y salidas del destino
+static void order_moves(const SearchPosition *pos, const WorkerState *w, int p, int ply, int hash_move,
+                        unsigned char *moves, int n)
+{
+    int keys[8];
+    for (int i = 0; i < n; i++)
+    {
+        int to = pos->head[p] + SEARCH_DIR_OFFSET[moves[i]];
+        keys[i] = position_reward(pos, to) * 16 + position_free_neighbours(pos, to);
+        if (moves[i] == hash_move)
+            keys[i] += 1 << 13;
+        else if (ply < SEARCH_MAX_PLY)
+        {
+            if (moves[i] == w->killers[ply][0])
+                keys[i] += 1 << 12;
+            else if (moves[i] == w->killers[ply][1])
+                keys[i] += 1 << 11;
+        }
+    }
+    for (int i = 1; i < n; i++)
+    {
+        int k = keys[i];
+        unsigned char m = moves[i];
+        int j = i - 1;
+        for (; j >= 0 && keys[j] < k; j--)
+        {
+            keys[j + 1] = keys[j];
+            moves[j + 1] = moves[j];
+        }
+        keys[j + 1] = k;
+        moves[j + 1] = m;
+    }
+}
+
+static void store_killer(WorkerState *w, int ply, unsigned char move)
+{
+    if (ply >= SEARCH_MAX_PLY || w->killers[ply][0] == move)
+        return;
+    w->killers[ply][1] = w->killers[ply][0];
+    w->killers[ply][0] = move;
+}
+
+static bool anyone_can_move(const SearchContext *ctx)
+{
+    for (int i = 0; i < ctx->engine->mover_count; i++)
+        if (position_mobility(ctx->pos, ctx->engine->movers[i]) > 0)
+            return true;
+    return false;
+}
+
+static int alphabeta(SearchContext *ctx, int depth, int ply, int alpha, int beta, int passes);
+static SearchContext worker_context(struct SearchEngineCDT *e, SearchPosition *pos, const CancelLink *cancel);
+
+static void run_split(WorkTask *task)
+{
+    SplitTask *st = (SplitTask *)task;
+    SplitPoint *sp = st->sp;
+    struct SearchEngineCDT *e = sp->engine;
+    SearchPosition pos = *sp->pos;
+    position_make(&pos, sp->mover, st->move);
+    SearchContext ctx = worker_context(e, &pos, &sp->link);
+    if (aborted(&ctx))
+        return;
+
+    // Lo que resolvieron las hermanas achica la ventana
+    int alpha = atomic_load(&sp->alpha), beta = atomic_load(&sp->beta);
+    bool limited_before = ctx.worker->depth_limited;
+    ctx.worker->depth_limited = false;
+    int v = alpha >= beta ? alpha : alphabeta(&ctx, sp->depth - 1, sp->ply + 1, alpha, beta, 0);
+    st->limited = ctx.worker->depth_limited;
+    // El hilo puede estar esperando por otro nodo: su marca vuelve como estaba
+    // y la de esta tarea la suma el dueño del punto de división
+    ctx.worker->depth_limited = limited_before;
+    if (aborted(&ctx))
+        return;
+    st->value = v;
+    st->done = true;
+    if (sp->maximise)
+    {
+        raise_bound(&sp->alpha, v);
+        if (v >= atomic_load(&sp->beta))
+            atomic_store(&sp->cutoff, true);
+    }
+    else
+    {
+        lower_bound(&sp->beta, v);
+        if (v <= atomic_load(&sp->alpha))
+            atomic_store(&sp->cutoff, true);
+    }
+}
+
+// Reparte moves entre tareas y espera. Devuelve false si la búsqueda se anuló
+// por encima de este nodo; si no, deja el mejor valor en *best y *best_move.
+static bool split_node(SearchContext *ctx, int depth, int ply, int p, bool maximise, const unsigned char *moves,
+                       int n, int alpha, int beta, int *best, int *best_move)
+{
+    struct SearchEngineCDT *e = ctx->engine;
+    SplitPoint sp = {.engine = e, .pos = ctx->pos, .depth = depth, .ply = ply, .mover = p, .maximise = maximise};
+    sp.link = (CancelLink){.flag = &sp.cutoff, .up = ctx->cancel};
+    atomic_init(&sp.alpha, alpha);
+    atomic_init(&sp.beta, beta);
+    atomic_init(&sp.cutoff, false);
+    WorkGroup group;
+    work_group_init(&group);
+    for (int i = n - 1; i >= 0; i--)
+    {
+        SplitTask *st = &sp.tasks[i];
+        st->task.run = run_split;
+        st->sp = &sp;
+        st->move = moves[i];
+        st->done = false;
+        st->limited = false;
+        work_pool_spawn(e->pool, &st->task, &group);
+    }
+    work_pool_wait(e->pool, &group);
+    if (aborted(ctx))
+        return false;
+
+    // Con un corte, las anuladas no hacen falta: alguna ya superó la ventana
+    for (int i = 0; i < n; i++)
+    {
+        const SplitTask *st = &sp.tasks[i];
+        if (!st->done)
+            continue;
+        ctx->worker->depth_limited = ctx->worker->depth_limited || st->limited;
+        if (maximise ? st->value > *best : st->value < *best)
+        {
+            *best = st->value;
+            *best_move = st->move;
+        }
+    }
+    if (atomic_load(&sp.cutoff))
+        store_killer(ctx->worker, ply, (unsigned char)*best_move);
+    return true;
+}
+
+// passes: turnos seguidos sin movimientos; si da la vuelta, nadie puede mover
+static int alphabeta(SearchContext *ctx, int depth, int ply, int alpha, int beta, int passes)
+{
+    WorkerState *w = ctx->worker;
+    if ((++w->nodes & TIME_CHECK_MASK) == 0 && monotonic_ns() >= ctx->engine->deadline_ns)
+        atomic_store(&ctx->engine->stop, true);
+    if (aborted(ctx))
+        return 0;
+    if (depth == 0)
+    {
+        if (!w->depth_limited && anyone_can_move(ctx))
+            w->depth_limited = true;
+        return evaluate(ctx);
+    }
+
+    SearchPosition *pos = ctx->pos;
+    struct SearchEngineCDT *e = ctx->engine;
+    int turn = ply % e->mover_count;
+    int p = e->movers[turn];
+    bool maximise = p == pos->me;
+    // Lo que otro hilo ya aseguró en la raíz también acota aquí. Se aplica en
+    // todos los nodos para que las cotas que se guardan sean relativas a la
+    // misma ventana en todo el árbol.
+    int shared = root_alpha(e);
+    if (shared > alpha)
+        alpha = shared;
+    if (alpha >= beta)
+        return alpha;
+
+    // Tras un turno pasado la misma posición no vale lo mismo: no se guarda
+    bool use_tt = e->tt != NULL && passes == 0;
+    uint64_t key = pos->hash ^ e->salt ^ e->side_key[turn];
+    TTEntry hit = {.move = TT_NO_MOVE};
+    // Un subárbol resuelto sin cortes por profundidad vale a cualquier profundidad
+    if (use_tt && tt_probe(e->tt, key, &hit) && (hit.depth >= depth || hit.complete) &&
+        (hit.bound == TT_BOUND_EXACT || (hit.bound == TT_BOUND_LOWER && hit.value >= beta) ||
+         (hit.bound == TT_BOUND_UPPER && hit.value <= alpha)))
+    {
+        w->tt_hits++;
+        if (!hit.complete)
+            w->depth_limited = true;
+        return hit.value;
+    }
+
+    unsigned char moves[8];
+    int n = position_moves(pos, p, moves);
+    if (n == 0)
+    {
+        if (passes + 1 >= e->mover_count)
+            return evaluate(ctx);
+        return alphabeta(ctx, depth - 1, ply + 1, alpha, beta, passes + 1);
+    }
+    order_moves(pos, w, p, ply, hit.move, moves, n);
+
+    int alpha0 = alpha, beta0 = beta;
+    bool limited_before = w->depth_limited;
+    w->depth_limited = false;
+    int best = maximise ? -VALUE_INF : VALUE_INF, best_move = TT_NO_MOVE;
+    // Con hilos de sobra, el primer hijo en serie fija la ventana y el resto se reparte
+    int serial = e->cfg.threads > 1 && depth >= SPLIT_MIN_DEPTH && n > 1 ? 1 : n;
+    for (int i = 0; i < serial; i++)
+    {
+        int reward = position_make(pos, p, moves[i]);
+        int v = alphabeta(ctx, depth - 1, ply + 1, alpha, beta, 0);
+        position_unmake(pos, p, moves[i], reward);
+        if (aborted(ctx))
+        {
+            w->depth_limited = limited_before || w->depth_limited;
+            return 0;
+        }
+        if (maximise ? v > best : v < best)
+        {
+            best = v;
+            best_move = moves[i];
+        }
+        if (maximise && v > alpha)
+            alpha = v;
+        else if (!maximise && v < beta)
+            beta = v;
+        if (alpha >= beta)
+        {
+            store_killer(w, ply, moves[i]);
+            break;
+        }
+    }
+    if (serial < n && alpha < beta &&
+        !split_node(ctx, depth, ply, p, maximise, moves + serial, n - serial, alpha, beta, &best, &best_move))
+    {
+        w->depth_limited = limited_before || w->depth_limited;
+        return 0;
+    }
+
+    bool complete = !w->depth_limited;
+    w->depth_limited = limited_before || w->depth_limited;
+    // Si la cota común creció hasta cerrar la ventana, lo que devolvieron los
+    // hijos no acota nada: no se guarda
+    int shared_now = root_alpha(e);
+    if (shared_now > alpha0)
+        alpha0 = shared_now;
+    if (use_tt && alpha0 < beta0)
+    {
+        TTEntry entry = {.value = best, .depth = depth, .move = best_move, .complete = complete};
+        entry.bound = best <= alpha0 ? TT_BOUND_UPPER : (best >= beta0 ? TT_BOUND_LOWER : TT_BOUND_EXACT);
+        tt_store(e->tt, key, &entry);
+    }
+    return best;
+}
+
+static SearchContext worker_context(struct SearchEngineCDT *e, SearchPosition *pos, const CancelLink *cancel)
+{
+    WorkerState *w = &e->workers[work_pool_worker_index(e->pool)];
+    return (SearchContext){.engine = e, .worker = w, .pos = pos, .cancel = cancel};
+}
+
+static void update_bound(RootTask *rt, int v)
+{
+    int cur = atomic_load(&rt->bound);
+    while ((rt->maximise ? v > cur : v < cur) && !atomic_compare_exchange_weak(&rt->bound, &cur, v))
+        ;
+}
+
+// Una respuesta de la capa 1, buscada en serie a partir de la capa 2
+static void run_child(WorkTask *task)
+{
+    ChildTask *ct = (ChildTask *)task;
+    RootTask *rt = ct->parent;
+    struct SearchEngineCDT *e = rt->engine;
+    if (atomic_load(&rt->refuted) || atomic_load(&e->stop))
+        return;
+    ct->pos = rt->pos;
+    position_make(&ct->pos, rt->mover, ct->move);
+
+    // La cota de las hermanas ya resueltas achica la ventana
+    int alpha = root_alpha(e), beta = VALUE_INF;
+    int bound = atomic_load(&rt->bound);
+    if (rt->maximise && bound > alpha)
+        alpha = bound;
+    else if (!rt->maximise)
+        beta = bound;
+
+    CancelLink link = {.flag = &rt->refuted, .up = NULL};
+    SearchContext ctx = worker_context(e, &ct->pos, &link);
+    int v = alpha >= beta ? alpha : alphabeta(&ctx, rt->depth - 2, 2, alpha, beta, 0);
+    if (aborted(&ctx))
+        return;
+    update_bound(rt, v);
+    // Una respuesta que deja al movimiento raíz por debajo de lo ya asegurado
+    // lo refuta: el resto de las respuestas no puede cambiar eso
+    if (!rt->maximise && v <= root_alpha(e))
+        atomic_store(&rt->refuted, true);
+}
+
+static void run_root(WorkTask *task)
+{
+    RootTask *rt = (RootTask *)task;
+    struct SearchEngineCDT *e = rt->engine;
+    rt->pos = *e->root;
+    position_make(&rt->pos, rt->pos.me, rt->move);
+    SearchContext ctx = worker_context(e, &rt->pos, NULL);
+
+    unsigned char moves[8];
+    int n = rt->depth > 1 ? position_moves(&rt->pos, rt->mover, moves) : 0;
+    int v;
+    if (n == 0)
+    {
+        // Hoja o turno pasado: no hay nada que repartir
+        v = alphabeta(&ctx, rt->depth - 1, 1, root_alpha(e), VALUE_INF, 0);
+        if (aborted(&ctx))
+            return;
+    }
+    else
+    {
+        order_moves(&rt->pos, ctx.worker, rt->mover, 1, TT_NO_MOVE, moves, n);
+        atomic_store(&rt->bound, rt->maximise ? -VALUE_INF : VALUE_INF);
+        atomic_store(&rt->refuted, false);
+        WorkGroup group;
+        work_group_init(&group);
+        // El dueño saca por el fondo: apilar al revés para correrlas en orden
+        for (int i = n - 1; i >= 0; i--)
+        {
+            ChildTask *ct = &rt->children[i];
+            ct->task.run = run_child;
+            ct->parent = rt;
+            ct->move = moves[i];
+            work_pool_spawn(e->pool, &ct->task, &group);
+        }
+        work_pool_wait(e->pool, &group);
+        if (atomic_load(&e->stop))
+            return;
+        v = atomic_load(&rt->bound);
+    }
+    publish_best(e, v, rt->move);
+}
+
+// El propio y los rivales a distancia de influir que además pueden entrar en
+// la región propia; un rival encerrado aparte no disputa ninguna celda
+static void select_movers(struct SearchEngineCDT *e, const SearchPosition *pos)
+{
+    uint64_t region[SEARCH_ROWS];
+    position_flood(pos, pos->head[pos->me], region);
+    e->mover_count = 0;
+    e->movers[e->mover_count++] = pos->me;
+    for (int p = 0; p < pos->player_count; p++)
+    {
+        if (p == pos->me || pos->head[p] == SEARCH_NO_CELL ||
+            position_distance(pos->head[p], pos->head[pos->me]) > SEARCH_OPPONENT_RADIUS)
+            continue;
+        int row = pos->head[p] / SEARCH_STRIDE, bit = pos->head[p] % SEARCH_STRIDE;
+        uint64_t near = (uint64_t)7 << (bit - 1);
+        if ((region[row - 1] | region[row] | region[row + 1]) & near)
+            e->movers[e->mover_count++] = p;
+    }
+}
+
+static bool any_depth_limited(const struct SearchEngineCDT *e)
+{
+    for (unsigned int i = 0; i < e->cfg.threads; i++)
+        if (e->workers[i].depth_limited)
+            return true;
+    return false;
+}
+
+SearchEngineADT search_engine_create(const SearchConfig *cfg)
+{
+    struct SearchEngineCDT *e = aligned_alloc(CACHE_LINE_SIZE, sizeof(*e));
+    if (e == NULL)
+        return NULL;
+    memset(e, 0, sizeof(*e));
+    e->cfg = *cfg;
+    if (e->cfg.threads < 1)
+        e->cfg.threads = 1;
+    e->workers = aligned_alloc(CACHE_LINE_SIZE, e->cfg.threads * sizeof(WorkerState));
+    bool ok = e->workers != NULL;
+    if (ok)
+    {
+        memset(e->workers, 0, e->cfg.threads * sizeof(WorkerState));
+        for (unsigned int i = 0; i < e->cfg.threads && ok; i++)
+            ok = (e->workers[i].voronoi = voronoi_create()) != NULL;
+    }
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        e->side_key[p] = mix64(0xD1B54A32D192ED03ull * (uint64_t)(p + 1));
+    if (ok && e->cfg.tt_mb > 0)
+        ok = (e->tt = tt_create((size_t)e->cfg.tt_mb << 20)) != NULL;
+    e->pool = ok ? work_pool_create(e->cfg.threads) : NULL;
+    if (e->pool == NULL)
+    {
+        int saved = errno;
+        search_engine_destroy(e);
+        errno = saved;
+        return NULL;
+    }
+    return e;
+}
+
+SearchResult search_engine_best_move(SearchEngineADT e, const SearchPosition *pos)
+{
+    SearchResult result = {.move = -1};
+    uint64_t start = monotonic_ns();
+    e->root = pos;
+    e->deadline_ns = start + (uint64_t)e->cfg.budget_ms * 1000000ull;
+    atomic_store(&e->stop, false);
+    for (unsigned int i = 0; i < e->cfg.threads; i++)
+    {
+        e->workers[i].nodes = 0;
+        e->workers[i].tt_hits = 0;
+        memset(e->workers[i].killers, NO_MOVE, sizeof(e->workers[i].killers));
+    }
+    select_movers(e, pos);
+    if (e->tt != NULL)
+    {
+        // Fuera de la ventana también se suman puntos: el puntaje de la raíz
+        // entra en la sal para que otra búsqueda no lea valores ajenos
+        uint64_t salt = mix64(((uint64_t)(uint32_t)pos->x0 << 32 | (uint32_t)pos->y0) ^ (uint64_t)pos->me << 24);
+        for (int i = 0; i < e->mover_count; i++)
+            salt = mix64(salt ^ ((uint64_t)e->movers[i] << 56 | (uint32_t)pos->score[e->movers[i]]));
+        for (int p = 0; p < pos->player_count; p++)
+            salt = mix64(salt ^ (uint32_t)pos->score[p]);
+        e->salt = salt;
+        tt_new_search(e->tt);
+    }
+
+    unsigned char root[8];
+    int n = position_moves(pos, pos->me, root);
+    if (n == 0)
+        return result;
+    order_moves(pos, &e->workers[0], pos->me, 0, TT_NO_MOVE, root, n);
+    result.move = root[0];
+    if (n == 1)
+        return result; // no hay nada que decidir
+
+    int mover = e->movers[1 % e->mover_count];
+    unsigned int max_depth = e->cfg.max_depth > SEARCH_MAX_PLY ? SEARCH_MAX_PLY : e->cfg.max_depth;
+    for (unsigned int depth = 1; depth <= max_depth; depth++)
+    {
+        for (unsigned int i = 0; i < e->cfg.threads; i++)
+            e->workers[i].depth_limited = false;
+        atomic_store(&e->best, pack_best(-VALUE_INF, NO_MOVE));
+        for (int i = 0; i < n; i++)
+        {
+            RootTask *rt = &e->roots[i];
+            rt->task.run = run_root;
+            rt->engine = e;
+            rt->move = root[i];
+            rt->depth = (int)depth;
+            rt->mover = mover;
+            rt->maximise = mover == pos->me;
+        }
+
+        // La variante principal primero: fija la cota con la que se poda el resto
+        WorkGroup group;
+        work_group_init(&group);
+        work_pool_spawn(e->pool, &e->roots[0].task, &group);
+        work_pool_wait(e->pool, &group);
+        bool pv_done = !atomic_load(&e->stop);
+        if (pv_done)
+        {
+            for (int i = n - 1; i >= 1; i--)
+                work_pool_spawn(e->pool, &e->roots[i].task, &group);
+            work_pool_wait(e->pool, &group);
+        }
+
+        // Incompleta: sólo sirve si ya reevaluó la variante principal, en cuyo
+        // caso lo publicado es al menos tan bueno como ella
+        uint64_t best = atomic_load(&e->best);
+        if (atomic_load(&e->stop))
+        {
+            if (pv_done && (best & 0xFF) != NO_MOVE)
+            {
+                result.move = (int)(best & 0xFF);
+                result.value = best_value(best);
+            }
+            break;
+        }
+        result.move = (int)(best & 0xFF);
+        result.value = best_value(best);
+        result.depth = depth;
+
+        // La variante principal va primero en la próxima iteración
+        int k = 0;
+        while (root[k] != result.move)
+            k++;
+        memmove(root + 1, root, (size_t)k);
+        root[0] = (unsigned char)result.move;
+
+        if (!any_depth_limited(e))
+        {
+            result.exact = true;
+            break;
+        }
+        // Otra iteración cuesta varias veces la anterior: no empezarla si no entra
+        if (monotonic_ns() - start > (uint64_t)e->cfg.budget_ms * 500000ull)
+            break;
+    }
+    for (unsigned int i = 0; i < e->cfg.threads; i++)
+    {
+        result.nodes += e->workers[i].nodes;
+        result.tt_hits += e->workers[i].tt_hits;
+    }
+    return result;
+}
+
+void search_engine_destroy(SearchEngineADT e)
+{
+    if (e == NULL)
+        return;
+    work_pool_destroy(e->pool);
+    tt_destroy(e->tt);
+    if (e->workers != NULL)
+        for (unsigned int i = 0; i < e->cfg.threads; i++)
+            voronoi_destroy(e->workers[i].voronoi);
+    free(e->workers);
+    free(e);
+}
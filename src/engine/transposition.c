@@ -0,0 +1,147 @@
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "transposition.h"
+
+#define BUCKET_ENTRIES 4
+
+// Datos empaquetados en 64 bits:
+//   0..31 valor, 32..39 profundidad, 40..41 cota, 42..45 movimiento,
+//   46 completo, 48..55 generación. Una entrada vacía vale 0 (cota 0).
+typedef struct
+{
+    _Atomic uint64_t check; // clave ^ datos
+    _Atomic uint64_t data;
+} Entry;
+
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) Entry entries[BUCKET_ENTRIES];
+} Bucket;
+
+struct TranspositionCDT
+{
+    Bucket *buckets;
+    uint64_t mask;
+    unsigned int generation; // 8 bits
+};
+
+_Static_assert(sizeof(Bucket) == CACHE_LINE_SIZE, "una cubeta por línea de caché");
+
+static inline uint64_t pack(const TTEntry *e, unsigned int generation)
+{
+    return (uint64_t)(uint32_t)e->value | (uint64_t)(e->depth & 0xFF) << 32 | (uint64_t)(e->bound & 3) << 40 |
+           (uint64_t)(e->move & 0xF) << 42 | (uint64_t)(e->complete ? 1 : 0) << 46 |
+           (uint64_t)(generation & 0xFF) << 48;
+}
+
+static inline void unpack(uint64_t data, TTEntry *e)
+{
+    e->value = (int)(uint32_t)data;
+    e->depth = (int)((data >> 32) & 0xFF);
+    e->bound = (int)((data >> 40) & 3);
+    e->move = (int)((data >> 42) & 0xF);
+    e->complete = (data >> 46) & 1;
+}
+
+static inline unsigned int data_generation(uint64_t data)
+{
+    return (unsigned int)(data >> 48) & 0xFF;
+}
+
+TranspositionADT tt_create(size_t bytes)
+{
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+        count *= 2;
+    if (bytes < sizeof(Bucket))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct TranspositionCDT *tt = malloc(sizeof(*tt));
+    if (tt == NULL)
+        return NULL;
+    tt->buckets = aligned_alloc(CACHE_LINE_SIZE, count * sizeof(Bucket));
+    if (tt->buckets == NULL)
+    {
+        free(tt);
+        return NULL;
+    }
+    memset(tt->buckets, 0, count * sizeof(Bucket));
+    tt->mask = count - 1;
+    tt->generation = 0;
+    return tt;
+}
+
+void tt_destroy(TranspositionADT tt)
+{
+    if (tt == NULL)
+        return;
+    free(tt->buckets);
+    free(tt);
+}
+
+void tt_new_search(TranspositionADT tt)
+{
+    tt->generation = (tt->generation + 1) & 0xFF;
+}
+
+// Las claves son de Zobrist: los bits bajos ya están mezclados
+static inline Bucket *bucket_for(TranspositionADT tt, uint64_t key)
+{
+    return &tt->buckets[key & tt->mask];
+}
+
+bool tt_probe(TranspositionADT tt, uint64_t key, TTEntry *out)
+{
+    Bucket *b = bucket_for(tt, key);
+    for (int i = 0; i < BUCKET_ENTRIES; i++)
+    {
+        uint64_t data = atomic_load_explicit(&b->entries[i].data, memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&b->entries[i].check, memory_order_relaxed);
+        if ((check ^ data) == key && data != 0)
+        {
+            unpack(data, out);
+            return true;
+        }
+    }
+    return false;
+}
+
+void tt_store(TranspositionADT tt, uint64_t key, const TTEntry *entry)
+{
+    Bucket *b = bucket_for(tt, key);
+    Entry *victim = NULL;
+    int victim_worth = 0;
+    for (int i = 0; i < BUCKET_ENTRIES; i++)
+    {
+        Entry *slot = &b->entries[i];
+        uint64_t data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+        bool current = data_generation(data) == tt->generation;
+        int depth = (int)((data >> 32) & 0xFF);
+        if ((check ^ data) == key && data != 0)
+        {
+            // Misma posición: no perder una búsqueda más profunda de esta ronda
+            if (current && depth > entry->depth && entry->bound != TT_BOUND_EXACT)
+                return;
+            victim = slot;
+            break;
+        }
+        // Vale menos lo vacío, después lo de búsquedas anteriores, después lo
+        // menos profundo
+        int worth = data == 0 ? -1 : (current ? 256 : 0) + depth;
+        if (victim == NULL || worth < victim_worth)
+        {
+            victim = slot;
+            victim_worth = worth;
+        }
+    }
+    uint64_t data = pack(entry, tt->generation);
+    atomic_store_explicit(&victim->data, data, memory_order_relaxed);
+    atomic_store_explicit(&victim->check, key ^ data, memory_order_relaxed);
+}
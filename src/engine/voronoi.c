@@ -0,0 +1,275 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "voronoi.h"
+
+#define DIST_BITS 8
+#define DIST_UNREACHED 0xFF // todos los planos en 1
+
+// Capas de un jugador: reach[d] son las celdas a distancia <= d de la cabeza
+// (la cabeza incluida, aunque no esté libre). Crecen hasta no cambiar. La
+// distancia de cada celda se guarda además en planos de bits (dist[b] es el
+// bit b), para comparar las de todos los jugadores 64 celdas a la vez.
+typedef struct
+{
+    int head;
+    int layers; // reach[0..layers-1] válidas; la última es todo lo alcanzable
+    uint64_t reach[VORONOI_MAX_LAYERS][SEARCH_ROWS];
+    uint64_t dist[DIST_BITS][SEARCH_ROWS];
+} PlayerReach;
+
+struct VoronoiCDT
+{
+    bool valid;
+    int x0, y0, width, height, player_count;
+    unsigned long long layers_built;
+    uint64_t free[SEARCH_ROWS]; // el tablero con el que se calcularon las capas
+    PlayerReach players[MAX_PLAYERS];
+};
+
+static const uint64_t EMPTY_ROWS[SEARCH_ROWS];
+
+VoronoiADT voronoi_create(void)
+{
+    struct VoronoiCDT *v = malloc(sizeof(*v));
+    if (v == NULL)
+        return NULL;
+    v->valid = false;
+    v->layers_built = 0;
+    return v;
+}
+
+void voronoi_destroy(VoronoiADT v)
+{
+    free(v);
+}
+
+unsigned long long voronoi_layers_built(VoronoiADT v)
+{
+    return v->layers_built;
+}
+
+static inline uint64_t dilate(uint64_t row)
+{
+    return row | (row << 1) | (row >> 1);
+}
+
+// Rehace las capas desde from (las anteriores siguen valiendo). Sólo se dilata
+// el frente, la última capa: lo de antes ya dio todo lo que podía dar.
+static void expand(struct VoronoiCDT *v, PlayerReach *pr, int from)
+{
+    if (pr->head == SEARCH_NO_CELL)
+    {
+        pr->layers = 0;
+        return;
+    }
+    int last = v->height + 1; // filas 1..height; la 0 y la last quedan vacías
+    if (from == 0)
+    {
+        int row = pr->head / SEARCH_STRIDE;
+        uint64_t bit = (uint64_t)1 << (pr->head % SEARCH_STRIDE);
+        memset(pr->reach[0], 0, sizeof(pr->reach[0]));
+        memset(pr->dist, 0xFF, sizeof(pr->dist));
+        pr->reach[0][row] = bit;
+        for (int b = 0; b < DIST_BITS; b++)
+            pr->dist[b][row] &= ~bit;
+        v->layers_built++;
+        from = 1;
+    }
+    else
+    {
+        // Lo que no estaba a menos de from pasos vuelve a inalcanzable
+        for (int y = 1; y < last; y++)
+            for (int b = 0; b < DIST_BITS; b++)
+                pr->dist[b][y] |= ~pr->reach[from - 1][y];
+    }
+    // El frente es lo que agregó la última capa; sólo se recorren sus filas y
+    // las vecinas, el resto de la capa es copia de la anterior
+    uint64_t fronts[2][SEARCH_ROWS] = {{0}};
+    uint64_t *front = fronts[0], *grown = fronts[1];
+    const uint64_t *older = from >= 2 ? pr->reach[from - 2] : EMPTY_ROWS;
+    int lo = last, hi = 0;
+    for (int y = 1; y < last; y++)
+    {
+        front[y] = pr->reach[from - 1][y] & ~older[y];
+        if (front[y])
+        {
+            lo = y < lo ? y : lo;
+            hi = y;
+        }
+    }
+    for (int d = from; d < VORONOI_MAX_LAYERS; d++)
+    {
+        if (lo > hi)
+        {
+            pr->layers = d;
+            return;
+        }
+        const uint64_t *prev = pr->reach[d - 1];
+        uint64_t *next = pr->reach[d];
+        memcpy(next, prev, (size_t)(last + 1) * sizeof(uint64_t));
+        int from_row = lo > 1 ? lo - 1 : 1, to_row = hi < last - 1 ? hi + 1 : last - 1;
+        int next_lo = last, next_hi = 0;
+        for (int y = from_row; y <= to_row; y++)
+        {
+            uint64_t reached = (dilate(front[y - 1]) | dilate(front[y]) | dilate(front[y + 1])) & v->free[y] & ~prev[y];
+            grown[y] = reached;
+            if (reached)
+            {
+                next[y] |= reached;
+                next_lo = y < next_lo ? y : next_lo;
+                next_hi = y;
+                for (int b = 0; b < DIST_BITS; b++)
+                    if (!((d >> b) & 1))
+                        pr->dist[b][y] &= ~reached;
+            }
+        }
+        v->layers_built++;
+        for (int y = lo; y <= hi; y++)
+            front[y] = 0;
+        uint64_t *swap = front;
+        front = grown;
+        grown = swap;
+        if (next_lo > next_hi)
+        {
+            pr->layers = d; // la capa d no agregó nada: no se guarda
+            return;
+        }
+        lo = next_lo;
+        hi = next_hi;
+    }
+    pr->layers = VORONOI_MAX_LAYERS;
+}
+
+static inline bool touches(const uint64_t *rows, int cell)
+{
+    int row = cell / SEARCH_STRIDE, bit = cell % SEARCH_STRIDE;
+    return ((rows[row - 1] | rows[row] | rows[row + 1]) & ((uint64_t)7 << (bit - 1))) != 0;
+}
+
+// Primera capa que puede cambiar si cell cambia: la siguiente a la primera
+// que la toca. Las capas son crecientes, así que se busca por bisección.
+static int first_affected(const PlayerReach *pr, int cell)
+{
+    if (pr->layers == 0 || !touches(pr->reach[pr->layers - 1], cell))
+        return INT_MAX;
+    int lo = 0, hi = pr->layers - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (touches(pr->reach[mid], cell))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo + 1;
+}
+
+static void update(struct VoronoiCDT *v, const SearchPosition *pos)
+{
+    int restart[MAX_PLAYERS];
+    bool same_window = v->valid && v->x0 == pos->x0 && v->y0 == pos->y0 && v->width == pos->width &&
+                       v->height == pos->height && v->player_count == pos->player_count;
+    if (!same_window)
+    {
+        v->x0 = pos->x0;
+        v->y0 = pos->y0;
+        v->width = pos->width;
+        v->height = pos->height;
+        v->player_count = pos->player_count;
+        for (int p = 0; p < pos->player_count; p++)
+            restart[p] = 0;
+    }
+    else
+    {
+        for (int p = 0; p < pos->player_count; p++)
+            restart[p] = v->players[p].head != pos->head[p] ? 0 : INT_MAX;
+        for (int y = 1; y <= pos->height; y++)
+        {
+            uint64_t changed = v->free[y] ^ pos->free[y];
+            while (changed)
+            {
+                int cell = y * SEARCH_STRIDE + __builtin_ctzll(changed);
+                changed &= changed - 1;
+                for (int p = 0; p < pos->player_count; p++)
+                {
+                    if (restart[p] == 0)
+                        continue;
+                    int k = first_affected(&v->players[p], cell);
+                    if (k < restart[p])
+                        restart[p] = k;
+                }
+            }
+        }
+    }
+
+    memcpy(v->free, pos->free, sizeof(v->free));
+    for (int p = 0; p < pos->player_count; p++)
+    {
+        v->players[p].head = pos->head[p];
+        if (restart[p] != INT_MAX)
+            expand(v, &v->players[p], restart[p]);
+    }
+    v->valid = true;
+}
+
+void voronoi_evaluate(VoronoiADT v, const SearchPosition *pos, VoronoiShare share[MAX_PLAYERS])
+{
+    update(v, pos);
+
+    // Una celda es de p si su distancia es la mínima y nadie más la iguala. Se
+    // compara en planos de bits, del más significativo al menos: lt marca las
+    // celdas donde ya se sabe que la distancia nueva es menor, eq donde todavía
+    // son iguales.
+    uint64_t owned[MAX_PLAYERS][SEARCH_ROWS];
+    int count = pos->player_count;
+    for (int y = 1; y <= pos->height; y++)
+    {
+        uint64_t min[DIST_BITS], tie = 0;
+        memset(min, 0xFF, sizeof(min));
+        for (int p = 0; p < count; p++)
+        {
+            const PlayerReach *pr = &v->players[p];
+            if (pr->layers == 0)
+                continue;
+            uint64_t lt = 0, eq = ~(uint64_t)0;
+            for (int b = DIST_BITS - 1; b >= 0; b--)
+            {
+                lt |= eq & ~pr->dist[b][y] & min[b];
+                eq &= ~(pr->dist[b][y] ^ min[b]);
+            }
+            tie = (tie & ~lt) | eq;
+            for (int b = 0; b < DIST_BITS; b++)
+                min[b] = (pr->dist[b][y] & lt) | (min[b] & ~lt);
+        }
+        uint64_t reached = 0;
+        for (int b = 0; b < DIST_BITS; b++)
+            reached |= ~min[b];
+        uint64_t unique = reached & ~tie & pos->free[y];
+        for (int p = 0; p < count; p++)
+        {
+            const PlayerReach *pr = &v->players[p];
+            uint64_t eq = pr->layers == 0 ? 0 : unique;
+            for (int b = 0; b < DIST_BITS; b++)
+                eq &= ~(pr->dist[b][y] ^ min[b]);
+            owned[p][y] = eq;
+        }
+    }
+
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        share[p] = (VoronoiShare){0, 0};
+    for (int p = 0; p < count; p++)
+    {
+        int planes[SEARCH_REWARD_PLANES] = {0};
+        for (int y = 1; y <= pos->height; y++)
+        {
+            uint64_t mine = owned[p][y];
+            share[p].cells += __builtin_popcountll(mine);
+            for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+                planes[k] += __builtin_popcountll(mine & pos->reward_plane[y][k]);
+        }
+        for (int k = 0; k < SEARCH_REWARD_PLANES; k++)
+            share[p].reward += planes[k] << k;
+    }
+}
@@ -0,0 +1,280 @@
+#define _POSIX_C_SOURCE 200809L // para pthread_sigmask
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "work_pool.h"
+
+#define DEQUE_CAPACITY 1024 // potencia de 2
+#define IDLE_ROUNDS 64      // vueltas de robo fallidas antes de dormir
+
+typedef struct
+{
+    _Alignas(CACHE_LINE_SIZE) atomic_long top; // lo tocan los ladrones
+    _Alignas(CACHE_LINE_SIZE) atomic_long bottom; // sólo lo escribe el dueño
+    _Atomic(WorkTask *) tasks[DEQUE_CAPACITY];
+} WorkDeque;
+
+struct WorkPoolCDT
+{
+    unsigned int threads;
+    WorkDeque *deques;
+    pthread_t *handles; // threads - 1
+    unsigned int started;
+    atomic_bool quit;
+    // Para dormir sin perder avisos: quien encola incrementa epoch y sólo
+    // despierta si hay durmientes; quien duerme se anota antes de mirar epoch
+    atomic_uint epoch;
+    atomic_int sleepers;
+    pthread_mutex_t sleep_mutex;
+    pthread_cond_t sleep_cond;
+};
+
+typedef struct
+{
+    struct WorkPoolCDT *pool;
+    unsigned int index;
+} WorkerStart;
+
+static _Thread_local unsigned int tls_worker_index = 0;
+static _Thread_local uint32_t tls_rng = 0x9E3779B9u;
+
+static bool deque_push(WorkDeque *q, WorkTask *task)
+{
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    if (b - t >= DEQUE_CAPACITY)
+        return false;
+    atomic_store_explicit(&q->tasks[b & (DEQUE_CAPACITY - 1)], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+static WorkTask *deque_pop(WorkDeque *q)
+{
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    if (t > b)
+    {
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    WorkTask *task = atomic_load_explicit(&q->tasks[b & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (t == b)
+    {
+        // Último elemento: se compite con los ladrones por él
+        if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1, memory_order_seq_cst,
+                                                     memory_order_relaxed))
+            task = NULL;
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+static WorkTask *deque_steal(WorkDeque *q)
+{
+    long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+    if (t >= b)
+        return NULL;
+    WorkTask *task = atomic_load_explicit(&q->tasks[t & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+        return NULL;
+    return task;
+}
+
+static void run_task(WorkTask *task)
+{
+    WorkGroup *group = task->group;
+    task->run(task);
+    atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release);
+}
+
+// Propia primero; si no hay, roba empezando por una víctima al azar
+static WorkTask *find_task(struct WorkPoolCDT *pool, unsigned int self)
+{
+    WorkTask *task = deque_pop(&pool->deques[self]);
+    if (task || pool->threads == 1)
+        return task;
+    tls_rng ^= tls_rng << 13;
+    tls_rng ^= tls_rng >> 17;
+    tls_rng ^= tls_rng << 5;
+    unsigned int start = tls_rng % pool->threads;
+    for (unsigned int i = 0; i < pool->threads; i++)
+    {
+        unsigned int victim = (start + i) % pool->threads;
+        if (victim != self && (task = deque_steal(&pool->deques[victim])) != NULL)
+            return task;
+    }
+    return NULL;
+}
+
+static void *worker_thread(void *arg)
+{
+    WorkerStart start = *(WorkerStart *)arg;
+    free(arg);
+    struct WorkPoolCDT *pool = start.pool;
+    tls_worker_index = start.index;
+    tls_rng ^= start.index * 0x85EBCA6Bu;
+
+    unsigned int idle = 0;
+    while (!atomic_load_explicit(&pool->quit, memory_order_acquire))
+    {
+        unsigned int seen = atomic_load(&pool->epoch);
+        WorkTask *task = find_task(pool, start.index);
+        if (task)
+        {
+            run_task(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < IDLE_ROUNDS)
+        {
+            sched_yield();
+            continue;
+        }
+        pthread_mutex_lock(&pool->sleep_mutex);
+        atomic_fetch_add(&pool->sleepers, 1);
+        while (atomic_load(&pool->epoch) == seen && !atomic_load(&pool->quit))
+            pthread_cond_wait(&pool->sleep_cond, &pool->sleep_mutex);
+        atomic_fetch_sub(&pool->sleepers, 1);
+        pthread_mutex_unlock(&pool->sleep_mutex);
+        idle = 0;
+    }
+    return NULL;
+}
+
+static void wake_sleepers(struct WorkPoolCDT *pool)
+{
+    atomic_fetch_add(&pool->epoch, 1);
+    if (atomic_load(&pool->sleepers) > 0)
+    {
+        pthread_mutex_lock(&pool->sleep_mutex);
+        pthread_cond_broadcast(&pool->sleep_cond);
+        pthread_mutex_unlock(&pool->sleep_mutex);
+    }
+}
+
+WorkPoolADT work_pool_create(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct WorkPoolCDT *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+        return NULL;
+    pool->threads = threads;
+    pool->deques = aligned_alloc(CACHE_LINE_SIZE, threads * sizeof(WorkDeque));
+    pool->handles = calloc(threads, sizeof(pthread_t));
+    if (pool->deques == NULL || pool->handles == NULL)
+    {
+        free(pool->deques);
+        free(pool->handles);
+        free(pool);
+        return NULL;
+    }
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        atomic_init(&pool->deques[i].top, 0);
+        atomic_init(&pool->deques[i].bottom, 0);
+    }
+    atomic_init(&pool->quit, false);
+    atomic_init(&pool->epoch, 0);
+    atomic_init(&pool->sleepers, 0);
+    pthread_mutex_init(&pool->sleep_mutex, NULL);
+    pthread_cond_init(&pool->sleep_cond, NULL);
+    tls_worker_index = 0;
+
+    // Los hilos no deben recibir las señales dirigidas al proceso
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int err = 0;
+    for (unsigned int i = 1; i < threads && err == 0; i++)
+    {
+        WorkerStart *start = malloc(sizeof(*start));
+        if (start == NULL)
+        {
+            err = ENOMEM;
+            break;
+        }
+        *start = (WorkerStart){pool, i};
+        err = pthread_create(&pool->handles[i - 1], NULL, worker_thread, start);
+        if (err == 0)
+            pool->started++;
+        else
+            free(start);
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0)
+    {
+        work_pool_destroy(pool);
+        errno = err;
+        return NULL;
+    }
+    return pool;
+}
+
+unsigned int work_pool_threads(WorkPoolADT pool)
+{
+    return pool->threads;
+}
+
+unsigned int work_pool_worker_index(WorkPoolADT pool)
+{
+    (void)pool;
+    return tls_worker_index;
+}
+
+void work_pool_spawn(WorkPoolADT pool, WorkTask *task, WorkGroup *group)
+{
+    task->group = group;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    if (!deque_push(&pool->deques[tls_worker_index], task))
+    {
+        run_task(task);
+        return;
+    }
+    if (pool->threads > 1)
+        wake_sleepers(pool);
+}
+
+void work_pool_wait(WorkPoolADT pool, WorkGroup *group)
+{
+    unsigned int self = tls_worker_index;
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0)
+    {
+        WorkTask *task = find_task(pool, self);
+        if (task)
+            run_task(task);
+        else
+            sched_yield(); // lo que falta lo está corriendo otro hilo
+    }
+}
+
+void work_pool_destroy(WorkPoolADT pool)
+{
+    if (pool == NULL)
+        return;
+    atomic_store(&pool->quit, true);
+    pthread_mutex_lock(&pool->sleep_mutex);
+    pthread_cond_broadcast(&pool->sleep_cond);
+    pthread_mutex_unlock(&pool->sleep_mutex);
+    for (unsigned int i = 0; i < pool->started; i++)
+        pthread_join(pool->handles[i], NULL);
+    pthread_cond_destroy(&pool->sleep_cond);
+    pthread_mutex_destroy(&pool->sleep_mutex);
+    free(pool->deques);
+    free(pool->handles);
+    free(pool);
+}
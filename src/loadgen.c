@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L // para clock_gettime y nanosleep
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+
+#include "game_state.h"
+#include "board.h"
+#include "game_rules.h"
+#include "game_sync.h"
+#include "shmADT.h"
+#include "trace.h"
+#include "sample_stats.h"
+
+// Jugador generador de carga: envía movimientos al ritmo configurado (o tan
+// rápido como el master los acepte), con una proporción configurable de
+// movimientos inválidos, y no abandona al quedar encerrado. Mide el tiempo de
+// ida y vuelta de cada solicitud (write -> crédito devuelto en player_can_move,
+// con un solo movimiento en vuelo sea cual sea -c) y lo resume por stderr al
+// terminar, ya que stdout es el pipe al master.
+//
+// Se configura por entorno porque el master sólo le pasa width y height:
+//   LOADGEN_RATE         movimientos por segundo (0 = sin límite, por defecto)
+//   LOADGEN_INVALID_PCT  porcentaje de movimientos inválidos a propósito (0-100)
+//   LOADGEN_SEED         semilla del generador (por defecto, el PID)
+
+#define LOADGEN_MAX_SAMPLES 1000000
+#define INVALID_DIRECTION 8 // fuera de las 8 direcciones y sin MOVE_PLAN_FLAG
+
+typedef struct
+{
+  unsigned long rate;
+  unsigned int invalid_pct;
+  unsigned int seed;
+} LoadgenArgs;
+
+typedef struct
+{
+  ShmADT state_shm;
+  GameState *state;
+  ShmADT sync_shm;
+  GameSync *sync;
+} LoadgenResources;
+
+typedef struct
+{
+  uint32_t *rtt_ns;
+  size_t count;
+  unsigned long long sent;
+  unsigned long long sent_invalid;
+} LoadgenStats;
+
+static unsigned long env_ulong(const char *name, unsigned long fallback)
+{
+  const char *v = getenv(name);
+  if (v == NULL || *v == '\0')
+    return fallback;
+  return strtoul(v, NULL, 10);
+}
+
+static bool parse_args(int argc, char **argv, LoadgenArgs *out_args)
+{
+  // width/height (si vienen) se ignoran: el mapeo sale de la cabecera
+  if (argc != 1 && argc != 3)
+  {
+    errno = EINVAL;
+    fprintf(stderr, "loadgen: invalid usage. Usage: %s [<width> <height>]\n", argv[0]);
+    return false;
+  }
+  out_args->rate = env_ulong("LOADGEN_RATE", 0);
+  out_args->invalid_pct = (unsigned int)env_ulong("LOADGEN_INVALID_PCT", 0);
+  out_args->seed = (unsigned int)env_ulong("LOADGEN_SEED", (unsigned long)getpid());
+  if (out_args->invalid_pct > 100)
+  {
+    errno = EINVAL;
+    fprintf(stderr, "loadgen: LOADGEN_INVALID_PCT must be between 0 and 100\n");
+    return false;
+  }
+  return true;
+}
+
+static bool init_resources(LoadgenResources *out_res)
+{
+  out_res->state_shm = game_state_open("loadgen", &out_res->state);
+  if (out_res->state_shm == NULL)
+    return false;
+
+  out_res->sync_shm = open_shm(GAME_SYNC_SHM_NAME, sizeof(GameSync), O_RDWR, 0600, PROT_READ | PROT_WRITE);
+  if (out_res->sync_shm == NULL)
+  {
+    fprintf(stderr,
+            "loadgen: failed to open shm '%s' (read/write, size=%zu): %s\n",
+            GAME_SYNC_SHM_NAME, sizeof(GameSync), strerror(errno));
+    close_shm(out_res->state_shm);
+    return false;
+  }
+  out_res->sync = (GameSync *)get_shm_pointer(out_res->sync_shm);
+  return true;
+}
+
+static void cleanup_resources(LoadgenResources *res)
+{
+  if (res->sync_shm)
+    close_shm(res->sync_shm);
+  if (res->state_shm)
+    close_shm(res->state_shm);
+}
+
+static bool find_me(GameState *state, GameSync *sync, unsigned *out_index)
+{
+  pid_t mypid = getpid();
+  bool found = false;
+  game_sync_reader_enter(sync);
+  for (unsigned i = 0; i < state->player_count && i < MAX_PLAYERS; i++)
+  {
+    if (state->player_info[i].pid == mypid)
+    {
+      *out_index = i;
+      found = true;
+      break;
+    }
+  }
+  game_sync_reader_exit(sync);
+  return found;
+}
+
+static inline bool cell_free(const GameState *state, int x, int y)
+{
+  return board_in_bounds(state, x, y) && board_get(state, x, y) > 0;
+}
+
+// Elige una dirección válida con la regla de Warnsdorff (la celda con menos
+// salidas libres), que recorre el tablero sin encerrarse pronto y sostiene la
+// carga durante más tiempo; los empates se rompen al azar. Si no hay ninguna
+// válida devuelve una inválida para seguir generando carga.
+// Devuelve false si la partida terminó.
+static bool choose_move(GameState *state, GameSync *sync, unsigned me, unsigned int *rng,
+                        bool want_invalid, unsigned char *out_dir, bool *out_invalid)
+{
+  unsigned char best_dirs[8];
+  int best_count = 0;
+  int best_exits = 9;
+
+  game_sync_reader_enter(sync);
+  bool finished = state->finished;
+  if (!finished && !want_invalid)
+  {
+    int x = (int)state->players[me].x;
+    int y = (int)state->players[me].y;
+    for (int d = 0; d < 8; d++)
+    {
+      int nx = x + GAME_DIR_DX[d];
+      int ny = y + GAME_DIR_DY[d];
+      if (!cell_free(state, nx, ny))
+        continue;
+      int exits = 0;
+      for (int e = 0; e < 8; e++)
+      {
+        if (cell_free(state, nx + GAME_DIR_DX[e], ny + GAME_DIR_DY[e]))
+          exits++;
+      }
+      if (exits < best_exits)
+      {
+        best_exits = exits;
+        best_count = 0;
+      }
+      if (exits == best_exits)
+        best_dirs[best_count++] = (unsigned char)d;
+    }
+  }
+  game_sync_reader_exit(sync);
+
+  if (finished)
+    return false;
+
+  if (best_count == 0)
+  {
+    *out_dir = INVALID_DIRECTION;
+    *out_invalid = true;
+  }
+  else
+  {
+    *out_dir = best_dirs[rand_r(rng) % (unsigned)best_count];
+    *out_invalid = false;
+  }
+  return true;
+}
+
+static bool wait_credit(GameSync *sync, unsigned me)
+{
+  TRACE_BEGIN(TRACE_CREDIT_WAIT);
+  while (sem_wait(&sync->player_can_move[me].sem) == -1)
+  {
+    if (errno != EINTR)
+    {
+      fprintf(stderr, "loadgen: error in sem_wait(player_can_move[%u]): %s\n", me, strerror(errno));
+      TRACE_END(TRACE_CREDIT_WAIT);
+      return false;
+    }
+  }
+  TRACE_END(TRACE_CREDIT_WAIT);
+  return true;
+}
+
+static void sleep_until_ns(uint64_t deadline)
+{
+  uint64_t now = monotonic_ns();
+  if (deadline <= now)
+    return;
+  uint64_t delta = deadline - now;
+  struct timespec ts = {.tv_sec = (time_t)(delta / 1000000000ULL), .tv_nsec = (long)(delta % 1000000000ULL)};
+  while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+    ;
+}
+
+static void run_loadgen_loop(const LoadgenArgs *args, LoadgenResources *res, LoadgenStats *stats)
+{
+  unsigned me = 0;
+  if (!find_me(res->state, res->sync, &me))
+  {
+    fprintf(stderr, "loadgen: PID %d not registered in GameState\n", (int)getpid());
+    return;
+  }
+
+  unsigned int rng = args->seed;
+  uint64_t period_ns = args->rate ? 1000000000ULL / args->rate : 0;
+  uint64_t next_send = monotonic_ns();
+
+  // Toma la ventana completa (-c) y se queda con ella: con créditos de sobra
+  // wait_credit volvería en el acto (una ida y vuelta de ~0) y habría varios
+  // movimientos en vuelo elegidos sobre un estado viejo. Así hay uno solo en
+  // vuelo y cada wait_credit cierra la ida y vuelta de la solicitud anterior.
+  // move_credits ya está publicado: find_me lo leyó después que los PIDs.
+  unsigned window = res->state->move_credits ? res->state->move_credits : 1;
+  for (unsigned c = 0; c < window; c++)
+  {
+    if (!wait_credit(res->sync, me))
+      return;
+  }
+
+  while (true)
+  {
+    if (period_ns)
+    {
+      sleep_until_ns(next_send);
+      next_send += period_ns;
+    }
+
+    bool want_invalid = args->invalid_pct && (unsigned)(rand_r(&rng) % 100) < args->invalid_pct;
+    unsigned char dir;
+    bool invalid;
+    TRACE_BEGIN(TRACE_PLAYER_THINK);
+    bool chosen = choose_move(res->state, res->sync, me, &rng, want_invalid, &dir, &invalid);
+    TRACE_END(TRACE_PLAYER_THINK);
+    if (!chosen)
+      break;
+
+    uint64_t t0 = monotonic_ns();
+    if (write(STDOUT_FILENO, &dir, 1) != 1)
+      break;
+    stats->sent++;
+    if (invalid)
+      stats->sent_invalid++;
+
+    if (!wait_credit(res->sync, me))
+      break;
+    uint64_t rtt = monotonic_ns() - t0;
+    if (stats->count < LOADGEN_MAX_SAMPLES)
+      stats->rtt_ns[stats->count++] = rtt > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt;
+  }
+}
+
+static void print_stats(LoadgenStats *stats)
+{
+  sample_stats_sort(stats->rtt_ns, stats->count);
+#define PCT_US(q) (sample_stats_percentile(stats->rtt_ns, stats->count, (q)) / 1000.0)
+  fprintf(stderr,
+          "loadgen: pid=%d sent=%llu invalid=%llu rtt_us p50=%.1f p90=%.1f p99=%.1f max=%.1f\n",
+          (int)getpid(), stats->sent, stats->sent_invalid,
+          PCT_US(0.50), PCT_US(0.90), PCT_US(0.99), PCT_US(1.0));
+#undef PCT_US
+}
+
+int main(int argc, char **argv)
+{
+  LoadgenArgs args;
+  if (!parse_args(argc, argv, &args))
+    return 1;
+
+  signal(SIGPIPE, SIG_IGN);
+
+  LoadgenStats stats = {0};
+  stats.rtt_ns = malloc(LOADGEN_MAX_SAMPLES * sizeof(uint32_t));
+  if (stats.rtt_ns == NULL)
+  {
+    fprintf(stderr, "loadgen: out of memory for latency samples\n");
+    return 1;
+  }
+
+  LoadgenResources res = {0};
+  if (!init_resources(&res))
+  {
+    free(stats.rtt_ns);
+    return 1;
+  }
+
+  trace_attach("loadgen");
+  run_loadgen_loop(&args, &res, &stats);
+  close(STDOUT_FILENO);
+  print_stats(&stats);
+
+  cleanup_resources(&res);
+  free(stats.rtt_ns);
+  return 0;
+}
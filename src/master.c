@@ -13,20 +13,24 @@
 #include <semaphore.h>
 #include <time.h>
 #include <sys/select.h>
-#include <math.h>
+#include <sys/ioctl.h>
 #include <stdarg.h>
 #include "shmADT.h"
 #include "game_state.h"
+#include "board.h"
+#include "board_stats.h"
 #include "game_sync.h"
 #include "constants.h"
+#include "sched_ctl.h"
+#include "checkpoint.h"
+#include "move_batch.h"
+#include "trace.h"
+#include "results_store.h"
+#include "game_rules.h"
+#include "move_sched.h"
+#include "board_file.h"
 
-// Shared direction vectors and common constants
-#define NUM_DIRECTIONS 8
 #define COORD_BUF_LEN 16
-#define BOARD_INDEX(state, X, Y) ((Y) * (state)->width + (X))
-static const int DIR_DX[NUM_DIRECTIONS] = {0, 1, 1, 1, 0, -1, -1, -1};
-static const int DIR_DY[NUM_DIRECTIONS] = {-1, -1, 0, 1, 1, 1, 0, -1};
-static const double SPAWN_RADIUS_DIVISOR = 3;
 
 static volatile sig_atomic_t stop_requested = 0;
 
@@ -36,11 +40,6 @@ static void handle_sigint_master(int sig)
     stop_requested = 1;
 }
 
-static inline int clampi(int v, int lo, int hi)
-{
-    return v < lo ? lo : (v > hi ? hi : v);
-}
-
 // Estructura para almacenar los argumentos parseados
 typedef struct
 {
@@ -49,9 +48,24 @@ typedef struct
     unsigned int delay;
     unsigned int timeout;
     unsigned int seed;
+    unsigned int move_credits;
     char *view_path;
     char *player_paths[MAX_PLAYERS];
     int player_count;
+    CpuPinning pinning;     // -a: afinidad de master, vista y jugadores
+    SchedSettings sched;    // -S: política de planificación para todos
+    char *checkpoint_path;  // -k: archivo de checkpoint (NULL = desactivado)
+    unsigned int checkpoint_interval_ms;
+    char *resume_path;      // -r: reanudar desde un checkpoint
+    char *board_path;       // -b: tablero inicial desde un archivo (NULL = aleatorio)
+    char *board_dump_path;  // -B: volcado del tablero final
+    BoardLayout board_layout; // -l: orden de las celdas en memoria
+    BoardMode board_mode;     // -g: recompensas procedurales materializadas por tile
+    unsigned int jobs;        // -j: hilos que aplican movimientos por lotes (0 = de a uno)
+    unsigned int tick_ms;     // -i: plazo de cada tick en modo simultáneo (0 = por orden de llegada)
+    MoveSchedConfig move_sched; // -q: a quién atender primero en el modo de a un movimiento
+    char *trace_path;         // -T: volcado de las trazas al terminar (NULL = sin trazas)
+    char *results_dir;        // -R: almacén columnar donde agregar el resultado
 } MasterArgs;
 
 // Estructura para almacenar los recursos del juego (IPC, etc.)
@@ -66,10 +80,26 @@ typedef struct
     int *player_pipes;    // Array de file descriptors para los extremos de lectura
     int *player_statuses; // Exit statuses de jugadores (para impresión posterior)
     int view_status;      // Exit status de la vista
+    int master_cpu;       // Última CPU observada de cada proceso (-1 = desconocida)
+    int view_cpu;
+    int *player_cpus;
+    long long game_start_ms; // Duración de la partida (para el throughput)
+    long long game_end_ms;
+    CheckpointADT checkpoint;   // Escritor asíncrono de checkpoints (-k)
+    long long last_checkpoint_ms;
+    GameState *resume_state;    // Estado cargado con -r (NULL = partida nueva)
+    CheckpointMeta resume_meta;
+    BoardFileADT board_file;    // Tablero abierto con -b hasta init_game_state
+    MoveBatchADT move_batch;    // Aplicador por lotes y regiones (-j, y siempre en modo -i)
+    unsigned long long ticks;   // Ticks resueltos (-i)
+    MoveSchedADT move_sched;    // Orden de atención (-q; sólo sin -j ni -i)
 } GameResources;
 
+// Avisa de un cambio de estado: a los espectadores sin esperarlos y a la
+// vista de -v, que sí marca el ritmo
 static inline void notify_view(const MasterArgs *args, GameResources *res)
 {
+    game_sync_publish(res->sync);
     if (!args->view_path)
     {
         return;
@@ -79,7 +109,9 @@ static inline void notify_view(const MasterArgs *args, GameResources *res)
     {
         return;
     }
+    TRACE_BEGIN(TRACE_VIEW_WAIT);
     sem_wait(&res->sync->view_print_done);
+    TRACE_END(TRACE_VIEW_WAIT);
     if (!stop_requested)
     {
         struct timespec delay = {.tv_sec = args->delay / 1000, .tv_nsec = (args->delay % 1000) * 1000000L};
@@ -89,14 +121,12 @@ static inline void notify_view(const MasterArgs *args, GameResources *res)
 
 static inline void lock_writer(GameResources *res)
 {
-    sem_wait(&res->sync->master_starvation_guard);
-    sem_wait(&res->sync->state_mutex);
-    sem_post(&res->sync->master_starvation_guard);
+    game_sync_writer_enter(res->sync);
 }
 
 static inline void unlock_writer(GameResources *res)
 {
-    sem_post(&res->sync->state_mutex);
+    game_sync_writer_exit(res->sync);
 }
 
 static inline void finish_game_and_notify(const MasterArgs *args, GameResources *res)
@@ -107,16 +137,26 @@ static inline void finish_game_and_notify(const MasterArgs *args, GameResources
     notify_view(args, res);
 }
 
+// Devuelve una ventana completa de créditos a cada jugador: un jugador puede
+// estar esperando todos sus créditos antes de mirar el estado.
+static void wake_all_players(const MasterArgs *args, GameResources *res)
+{
+    for (int i = 0; i < args->player_count; i++)
+    {
+        for (unsigned int c = 0; c < args->move_credits; c++)
+        {
+            sem_post(&res->sync->player_can_move[i].sem);
+        }
+    }
+}
+
 static void request_graceful_shutdown(const MasterArgs *args, GameResources *res)
 {
     // Marcar juego terminado y notificar a la vista (si existe)
     finish_game_and_notify(args, res);
 
     // Despertar a todos los jugadores para que salgan del semáforo si están esperando
-    for (int i = 0; i < args->player_count; i++)
-    {
-        sem_post(&res->sync->player_can_move[i]);
-    }
+    wake_all_players(args, res);
 
     // Cerrar pipes para desbloquear posibles escrituras/bloqueos
     if (res->player_pipes)
@@ -148,27 +188,18 @@ static inline long long monotonic_millis(void)
     return (long long)ts.tv_sec * 1000LL + (long long)(ts.tv_nsec / 1000000LL);
 }
 
-static bool any_player_can_move(const GameState *state)
+// La partida termina cuando no quedan jugadores activos o ninguno puede moverse
+static bool no_moves_left(const MasterArgs *args, const GameResources *res)
 {
-    for (unsigned int i = 0; i < state->player_count; i++)
+    int remaining_active = 0;
+    for (int p = 0; p < args->player_count; p++)
     {
-        const Player *p = &state->players[i];
-        if (p->blocked)
-            continue;
-        for (int m = 0; m < NUM_DIRECTIONS; m++)
+        if (!res->state->players[p].blocked && res->player_pipes[p] != -1)
         {
-            int nx = (int)p->x + DIR_DX[m];
-            int ny = (int)p->y + DIR_DY[m];
-            if (nx >= 0 && nx < (int)state->width && ny >= 0 && ny < (int)state->height)
-            {
-                if (state->board[BOARD_INDEX(state, nx, ny)] > 0)
-                {
-                    return true;
-                }
-            }
+            remaining_active++;
         }
     }
-    return false;
+    return remaining_active == 0 || !game_rules_any_can_move(res->state);
 }
 
 static bool launch_player(const MasterArgs *args, GameResources *res, int player_index, const char *width_str, const char *height_str)
@@ -203,6 +234,9 @@ static bool launch_player(const MasterArgs *args, GameResources *res, int player
         }
         close(pipe_fds[W_END]); // no necesito mas el original
 
+        // La afinidad y la política se heredan a través de execv
+        sched_ctl_apply_self("player", sched_ctl_cpu_for_slot(&args->pinning, SCHED_CTL_SLOT_PLAYER(player_index)), &args->sched);
+
         char *argv[] = {args->player_paths[player_index], (char *)width_str, (char *)height_str, NULL};
         execv(args->player_paths[player_index], argv);
         perror("execv player failed");
@@ -226,6 +260,7 @@ static bool launch_view(const MasterArgs *args, GameResources *res, const char *
     }
     if (pid == 0)
     { // Proceso hijo (vista)
+        sched_ctl_apply_self("view", sched_ctl_cpu_for_slot(&args->pinning, SCHED_CTL_SLOT_VIEW), &args->sched);
         char *argv[] = {args->view_path, (char *)width_str, (char *)height_str, NULL};
         execv(args->view_path, argv);
         perror("execv view failed");
@@ -263,123 +298,308 @@ static bool launch_children(const MasterArgs *args, GameResources *res)
     return true;
 }
 
+// Reconstruye el estado a partir de un checkpoint: tablero, puntajes y
+// posiciones se conservan; los jugadores relanzados tienen PIDs nuevos.
+static void restore_game_state(const MasterArgs *args, GameResources *res)
+{
+    GameState *state = res->state;
+    memcpy(state, res->resume_state, state->map_size);
+    game_state_init_header(state, args->width, args->height, args->board_layout, args->board_mode, args->seed);
+    state->finished = false;
+    for (int i = 0; i < args->player_count; i++)
+    {
+        PlayerInfo *info = &state->player_info[i];
+        info->pid = res->player_pids[i];
+        const char *base = strrchr(args->player_paths[i], '/');
+        base = base ? base + 1 : args->player_paths[i];
+        snprintf(info->name, sizeof(info->name), "%s", base);
+    }
+}
+
+// Inicializa el tablero con recompensas aleatorias. Se recorre en orden de
+// fila para que una semilla genere el mismo tablero en cualquier layout.
+static void init_eager_board(GameState *state)
+{
+    size_t storage_cells = BOARD_STORAGE_CELLS(state->width, state->height, state->board_layout);
+    for (size_t i = 0; i < storage_cells; i++)
+    {
+        state->board[i] = BOARD_CELL_VOID;
+    }
+    for (unsigned int y = 0; y < state->height; y++)
+    {
+        for (unsigned int x = 0; x < state->width; x++)
+        {
+            board_set(state, x, y, 1 + (rand() % 9)); // Recompensas entre 1 y 9
+        }
+    }
+}
+
 static void init_game_state(const MasterArgs *args, GameResources *res)
 {
+    if (res->resume_state)
+    {
+        restore_game_state(args, res);
+        return;
+    }
+
     srand(args->seed);
 
     GameState *state = res->state;
     state->width = args->width;
     state->height = args->height;
     state->player_count = args->player_count;
+    state->move_credits = args->move_credits;
     state->finished = false;
 
-    // Inicializar el tablero con recompensas aleatorias
-    for (unsigned int i = 0; i < state->width * state->height; i++)
+    // Con -b las celdas salen del archivo. En modo procedural no se escribe
+    // nada: cada tile se materializa con board_set la primera vez que alguien
+    // lo ocupa (empezando por los spawns).
+    if (res->board_file)
+    {
+        board_file_load(res->board_file, state);
+        board_file_close(res->board_file);
+        res->board_file = NULL;
+    }
+    else if (state->board_mode == BOARD_MODE_EAGER)
     {
-        state->board[i] = 1 + (rand() % 9); // Recompensas entre 1 y 9
+        init_eager_board(state);
     }
 
-    // state->board[BOARD_INDEX(state, args->width - 1, (args->height / 2))] = 4;
     //  Inicializar jugadores
     for (int i = 0; i < args->player_count; i++)
     {
-        Player *p = &state->players[i];
-        p->pid = res->player_pids[i];
-        p->score = 0;
-        p->valid_move_requests = 0;
-        p->invalid_move_requests = 0;
-        p->blocked = false;
+        PlayerInfo *info = &state->player_info[i];
+        info->pid = res->player_pids[i];
+        // El nombre visible es el del ejecutable del jugador
+        const char *base = strrchr(args->player_paths[i], '/');
+        base = base ? base + 1 : args->player_paths[i];
+        snprintf(info->name, sizeof(info->name), "%s", base);
+    }
+    game_rules_spawn_players(state);
+}
 
-        // Cálculo delíptico alrededor del centro del tablero
-        double radius_x = ((double)state->width) / SPAWN_RADIUS_DIVISOR;
-        double radius_y = ((double)state->height) / SPAWN_RADIUS_DIVISOR;
-        if (radius_x < 1.0)
-            radius_x = 1.0;
-        if (radius_y < 1.0)
-            radius_y = 1.0;
-        int center_x = (int)state->width / 2;
-        int center_y = (int)state->height / 2;
+// Lee el cuerpo de un plan. El jugador escribe cabecera y cuerpo en un único
+// write (<= PIPE_BUF, atómico), así que el cuerpo ya tiene que estar en el
+// pipe: si no está, el plan es inválido y no nos quedamos bloqueados.
+static bool read_plan_body(int fd, unsigned char *buf, size_t len)
+{
+    int available = 0;
+    if (ioctl(fd, FIONREAD, &available) == -1 || available < (int)len)
+        return false;
+    ssize_t n;
+    do
+    {
+        n = read(fd, buf, len);
+    } while (n == -1 && errno == EINTR);
+    return n == (ssize_t)len;
+}
 
-        double theta = (2.0 * M_PI * (double)i) / (double)state->player_count;
-        int tx = center_x + (int)lround(radius_x * cos(theta));
-        int ty = center_y + (int)lround(radius_y * sin(theta));
-        tx = clampi(tx, 0, (int)state->width - 1);
-        ty = clampi(ty, 0, (int)state->height - 1);
+static void block_player(int player_idx, int pipe_fd, const MasterArgs *args, GameResources *res)
+{
+    // Bloqueamos al jugador para que no se le considere más
+    lock_writer(res);
+    res->state->players[player_idx].blocked = true;
+    unlock_writer(res);
 
-        p->x = (unsigned short)tx;
-        p->y = (unsigned short)ty;
-        // Marcar la celda de spawn como ocupada por el jugador, según el enunciado (-id).
-        state->board[BOARD_INDEX(state, p->x, p->y)] = -(i);
-    }
+    close(pipe_fd);
+    res->player_pipes[player_idx] = -1; // Marcar como cerrado
+
+    // Notificar a la vista del cambio de estado (jugador bloqueado) si existe
+    notify_view(args, res);
 }
 
-static void process_player_move(int player_idx, int pipe_fd, const MasterArgs *args, GameResources *res)
+// Lee la solicitud pendiente de un jugador. Devuelve false (y bloquea al
+// jugador) ante EOF, error o un plan mal formado.
+static bool read_move_request(int player_idx, int pipe_fd, const MasterArgs *args, GameResources *res,
+                              MoveRequest *out)
 {
-    unsigned char move;
-    ssize_t bytes_read = read(pipe_fd, &move, sizeof(move));
+    TRACE_BEGIN(TRACE_PIPE_READ);
+    unsigned char request;
+    ssize_t bytes_read = read(pipe_fd, &request, sizeof(request));
+    TRACE_END(TRACE_PIPE_READ);
 
     if (bytes_read <= 0)
     { // EOF o error
         if (bytes_read != 0)
             perror("read from pipe failed");
+        block_player(player_idx, pipe_fd, args, res);
+        return false;
+    }
 
-        // Bloqueamos al jugador para que no se le considere más
-        sem_wait(&res->sync->state_mutex);
-        res->state->players[player_idx].blocked = true;
-        sem_post(&res->sync->state_mutex);
+    // Un byte suelto es un único movimiento; con MOVE_PLAN_FLAG le sigue un plan
+    size_t plan_len = 1;
+    out->plan[0] = request;
+    if (request & MOVE_PLAN_FLAG)
+    {
+        plan_len = request & MOVE_PLAN_LEN_MASK;
+        TRACE_BEGIN(TRACE_PIPE_READ);
+        bool body_ok = plan_len > 0 && read_plan_body(pipe_fd, out->plan, plan_len);
+        TRACE_END(TRACE_PIPE_READ);
+        if (!body_ok)
+        {
+            fprintf(stderr, "Player %d sent a malformed move plan.\n", player_idx);
+            block_player(player_idx, pipe_fd, args, res);
+            return false;
+        }
+    }
 
-        close(pipe_fd);
-        res->player_pipes[player_idx] = -1; // Marcar como cerrado
+    // Se aplican como mucho move_credits movimientos del plan
+    out->player = player_idx;
+    out->len = plan_len < args->move_credits ? (unsigned int)plan_len : args->move_credits;
+    return true;
+}
 
-        // Notificar a la vista del cambio de estado (jugador bloqueado) si existe
-        notify_view(args, res);
+// Devuelve al jugador los créditos consumidos por la solicitud
+static void return_credits(GameResources *res, const MoveRequest *req)
+{
+    for (unsigned int i = 0; i < req->len; i++)
+    {
+        sem_post(&res->sync->player_can_move[req->player].sem);
+    }
+}
 
+static void process_player_move(int player_idx, int pipe_fd, const MasterArgs *args, GameResources *res)
+{
+    MoveRequest req;
+    if (!read_move_request(player_idx, pipe_fd, args, res, &req))
         return;
+
+    // El plan entero se aplica bajo una sola sección de escritor, en orden;
+    // tras el primero inválido el resto se descarta
+    lock_writer(res);
+    TRACE_BEGIN(TRACE_MOVE_APPLY);
+    for (unsigned int i = 0; i < req.len; i++)
+    {
+        if (!game_rules_apply_move(res->state, player_idx, req.plan[i]))
+            break;
     }
+    TRACE_END(TRACE_MOVE_APPLY);
+    unlock_writer(res);
 
-    // Adquirir bloqueo de escritor para modificar el estado
-    sem_wait(&res->sync->master_starvation_guard);
-    sem_wait(&res->sync->state_mutex);
-    sem_post(&res->sync->master_starvation_guard);
+    // Notificar a la vista ante cualquier cambio de estado (válido o inválido)
+    notify_view(args, res);
 
-    GameState *state = res->state;
-    Player *player = &state->players[player_idx];
-    bool is_valid = false;
+    return_credits(res, &req);
+}
 
-    // Calcular nuevas coordenadas (lógica simple, se puede refinar)
-    if (move < NUM_DIRECTIONS)
+// Modo -j: toma las solicitudes de todos los jugadores listos, en orden de
+// turno desde first_player, y las aplica como un único lote bajo el lock de
+// escritor; los lectores ven el estado anterior o el posterior al lote.
+// Devuelve true si hubo algún movimiento válido.
+static bool process_move_batch(const fd_set *ready, int first_player, const MasterArgs *args, GameResources *res)
+{
+    MoveRequest requests[MAX_PLAYERS];
+    int count = 0;
+    for (int i = 0; i < args->player_count; i++)
     {
-        int nx = player->x + DIR_DX[move];
-        int ny = player->y + DIR_DY[move];
+        int player_idx = (first_player + i) % args->player_count;
+        int pipe_fd = res->player_pipes[player_idx];
+        if (pipe_fd == -1 || !FD_ISSET(pipe_fd, ready))
+            continue;
+        if (read_move_request(player_idx, pipe_fd, args, res, &requests[count]))
+            count++;
+    }
+    if (count == 0)
+        return false;
 
-        // Validar movimiento
-        if (nx >= 0 && nx < state->width && ny >= 0 && ny < state->height &&
-            state->board[BOARD_INDEX(state, nx, ny)] > 0)
-        {
+    lock_writer(res);
+    TRACE_BEGIN(TRACE_MOVE_APPLY);
+    move_batch_run(res->move_batch, res->state, requests, count);
+    TRACE_END(TRACE_MOVE_APPLY);
+    unlock_writer(res);
+    notify_view(args, res);
 
-            is_valid = true;
-            int reward = state->board[BOARD_INDEX(state, nx, ny)];
-            player->score += reward;
-            player->x = nx;
-            player->y = ny;
-            state->board[BOARD_INDEX(state, nx, ny)] = -(player_idx);
-            player->valid_move_requests++;
-        }
+    bool any_valid = false;
+    for (int i = 0; i < count; i++)
+    {
+        any_valid = any_valid || requests[i].valid > 0;
+        return_credits(res, &requests[i]);
     }
+    return any_valid;
+}
 
-    if (!is_valid)
+// Modo -i: cada tick junta a lo sumo una solicitud por jugador activo, hasta
+// que llegaron todas o vence el plazo, y las resuelve juntas en un único lote
+// con una sola notificación. Los movimientos son simultáneos: ante dos a la
+// misma celda gana el de mayor prioridad, que rota con el número de tick, así
+// que el resultado no depende del orden en que el SO despierta a cada uno.
+// Una solicitud que llega tarde queda para el tick siguiente.
+// Devuelve -1 si select falló, 0 si no hubo movimientos válidos y 1 si sí.
+static int run_tick(const MasterArgs *args, GameResources *res)
+{
+    MoveRequest slots[MAX_PLAYERS];
+    bool submitted[MAX_PLAYERS] = {false};
+    int waiting = 0;
+    for (int i = 0; i < args->player_count; i++)
     {
-        player->invalid_move_requests++;
+        if (!res->state->players[i].blocked && res->player_pipes[i] != -1)
+            waiting++;
     }
 
-    // Liberar bloqueo de escritor
-    unlock_writer(res);
+    long long deadline_ms = monotonic_millis() + args->tick_ms;
+    while (waiting > 0)
+    {
+        long long remaining_ms = deadline_ms - monotonic_millis();
+        if (remaining_ms <= 0)
+            break;
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        int max_fd = 0;
+        for (int i = 0; i < args->player_count; i++)
+        {
+            int fd = res->player_pipes[i];
+            if (!submitted[i] && !res->state->players[i].blocked && fd != -1)
+            {
+                FD_SET(fd, &read_fds);
+                if (fd > max_fd)
+                    max_fd = fd;
+            }
+        }
+        struct timeval timeout = {.tv_sec = (time_t)(remaining_ms / 1000LL),
+                                  .tv_usec = (suseconds_t)((remaining_ms % 1000LL) * 1000LL)};
+        int ready_fds = select(max_fd + 1, &read_fds, NULL, NULL, &timeout);
+        if (ready_fds == -1)
+            return -1;
+        if (ready_fds == 0)
+            break;
+        for (int i = 0; i < args->player_count; i++)
+        {
+            int fd = res->player_pipes[i];
+            if (submitted[i] || fd == -1 || !FD_ISSET(fd, &read_fds))
+                continue;
+            // Una solicitud fallida bloquea al jugador: tampoco se lo espera más
+            submitted[i] = read_move_request(i, fd, args, res, &slots[i]);
+            waiting--;
+        }
+    }
 
-    // Notificar al jugador correspondiente que su solicitud fue procesada
-    sem_post(&res->sync->player_can_move[player_idx]);
+    MoveRequest requests[MAX_PLAYERS];
+    int count = 0;
+    int first = (int)(res->ticks % (unsigned long long)args->player_count);
+    for (int k = 0; k < args->player_count; k++)
+    {
+        int i = (first + k) % args->player_count;
+        if (submitted[i])
+            requests[count++] = slots[i];
+    }
+    res->ticks++;
+    if (count == 0)
+        return 0;
 
-    // Notificar a la vista ante cualquier cambio de estado (válido o inválido)
+    lock_writer(res);
+    TRACE_BEGIN(TRACE_MOVE_APPLY);
+    move_batch_run(res->move_batch, res->state, requests, count);
+    TRACE_END(TRACE_MOVE_APPLY);
+    unlock_writer(res);
     notify_view(args, res);
+
+    bool any_valid = false;
+    for (int i = 0; i < count; i++)
+    {
+        any_valid = any_valid || requests[i].valid > 0;
+        return_credits(res, &requests[i]);
+    }
+    return any_valid ? 1 : 0;
 }
 
 static void cleanup_game_resources(GameResources *res, int player_count)
@@ -394,7 +614,7 @@ static void cleanup_game_resources(GameResources *res, int player_count)
         sem_destroy(&res->sync->readers_count_mutex);
         for (int i = 0; i < player_count && i < MAX_PLAYERS; i++)
         {
-            sem_destroy(&res->sync->player_can_move[i]);
+            sem_destroy(&res->sync->player_can_move[i].sem);
         }
     }
 
@@ -418,6 +638,30 @@ static void cleanup_game_resources(GameResources *res, int player_count)
     {
         free(res->player_statuses);
     }
+    if (res->player_cpus)
+    {
+        free(res->player_cpus);
+    }
+    if (res->checkpoint)
+    {
+        checkpoint_destroy(res->checkpoint);
+        res->checkpoint = NULL;
+    }
+    if (res->move_sched)
+    {
+        move_sched_destroy(res->move_sched);
+        res->move_sched = NULL;
+    }
+    if (res->move_batch)
+    {
+        move_batch_destroy(res->move_batch);
+        res->move_batch = NULL;
+    }
+    trace_destroy();
+    free(res->resume_state);
+    res->resume_state = NULL;
+    board_file_close(res->board_file);
+    res->board_file = NULL;
     if (res->state_shm)
     {
         destroy_shm(res->state_shm);
@@ -458,9 +702,101 @@ static void print_finish_status(const MasterArgs *args, GameResources *res)
     }
 }
 
+static void print_game_stats(const MasterArgs *args, const GameResources *res)
+{
+    unsigned long long valid = 0, invalid = 0;
+    for (int i = 0; i < args->player_count; i++)
+    {
+        valid += res->state->players[i].valid_move_requests;
+        invalid += res->state->players[i].invalid_move_requests;
+    }
+    double seconds = (double)(res->game_end_ms - res->game_start_ms) / 1000.0;
+    printf("Game stats: %llu requests (%llu valid, %llu invalid) in %.3f s (%.0f requests/s)\n",
+           valid + invalid, valid, invalid, seconds, seconds > 0 ? (double)(valid + invalid) / seconds : 0.0);
+    if (args->tick_ms > 0)
+    {
+        printf("Tick stats: %llu ticks of at most %u ms, %.2f requests per tick\n", res->ticks, args->tick_ms,
+               res->ticks > 0 ? (double)(valid + invalid) / (double)res->ticks : 0.0);
+    }
+
+    BoardStats board;
+    board_stats_board(res->state, &board);
+    printf("Board stats (%s): %llu free cells, %llu reward left", board_stats_kernel_name(),
+           (unsigned long long)board.free_cells, (unsigned long long)board.reward_sum);
+    if (res->state->board_mode == BOARD_MODE_PROCEDURAL)
+    {
+        printf(", %llu unexplored cells", (unsigned long long)board.unexplored_cells);
+    }
+    printf(", territory");
+    for (int i = 0; i < args->player_count; i++)
+    {
+        printf(" p%d=%llu", i, (unsigned long long)board.owned_cells[i]);
+    }
+    printf("\n");
+}
+
+// Agrega el resultado de la partida al almacén de -R
+static void record_results(const MasterArgs *args, const GameResources *res)
+{
+    GameResult result = {
+        .seed = args->seed,
+        .width = args->width,
+        .height = args->height,
+        .duration_ms = (uint32_t)(res->game_end_ms - res->game_start_ms),
+        .player_count = (uint32_t)args->player_count,
+    };
+    for (int i = 0; i < args->player_count; i++)
+    {
+        const Player *p = &res->state->players[i];
+        result.players[i] = (PlayerResult){
+            .binary = args->player_paths[i],
+            .score = p->score,
+            .valid = p->valid_move_requests,
+            .invalid = p->invalid_move_requests,
+            .exit_status = res->player_statuses[i],
+        };
+    }
+    if (results_append(args->results_dir, &result))
+    {
+        printf("Results appended to %s\n", args->results_dir);
+    }
+    else
+    {
+        fprintf(stderr, "Error: Could not append results to '%s'.\n", args->results_dir);
+    }
+}
+
+static void print_cpu_report(const MasterArgs *args, const GameResources *res)
+{
+    printf("CPU report: master=%d", res->master_cpu);
+    if (res->view_pid > 0)
+    {
+        printf(" view=%d", res->view_cpu);
+    }
+    for (int i = 0; i < args->player_count; i++)
+    {
+        printf(" player%d=%d", i, res->player_cpus[i]);
+    }
+    printf("\n");
+}
+
 static void print_usage(const char *exec_name)
 {
-    fprintf(stderr, "Usage: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-v view_path] -p player1 [player2 ...]\\n", exec_name);
+    fprintf(stderr, "Usage: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-c move_credits] [-a auto|cpu,...] [-S fifo:prio|nice:n] [-k checkpoint [-K interval_ms]] [-r checkpoint] [-b board_file] [-B board_dump] [-l rowmajor|tiled] [-g] [-j jobs] [-i tick_ms] [-q rotation|fifo|drr[:quantum]|edf[:period_ms]] [-T trace_dump] [-R results_dir] [-v view_path] -p player1 [player2 ...]\\n", exec_name);
+}
+
+// -j N: sólo dígitos, entre 1 y MAX_MOVE_JOBS (atoi aceptaría "-j x" como 0)
+static bool parse_jobs(const char *text, unsigned int *out)
+{
+    if (text[0] < '0' || text[0] > '9')
+        return false;
+    char *end;
+    errno = 0;
+    unsigned long jobs = strtoul(text, &end, 10);
+    if (errno != 0 || *end != '\0' || jobs < 1 || jobs > MAX_MOVE_JOBS)
+        return false;
+    *out = (unsigned int)jobs;
+    return true;
 }
 
 static bool parse_args(int argc, char **argv, MasterArgs *args)
@@ -471,12 +807,27 @@ static bool parse_args(int argc, char **argv, MasterArgs *args)
     args->delay = DEFAULT_DELAY;
     args->timeout = DEFAULT_TIMEOUT;
     args->seed = time(NULL);
+    args->move_credits = DEFAULT_MOVE_CREDITS;
+    args->pinning = (CpuPinning){0};
+    args->sched = (SchedSettings){0};
+    args->checkpoint_path = NULL;
+    args->checkpoint_interval_ms = DEFAULT_CHECKPOINT_INTERVAL_MS;
+    args->resume_path = NULL;
+    args->board_path = NULL;
+    args->board_dump_path = NULL;
+    args->board_layout = BOARD_LAYOUT_ROW_MAJOR;
+    args->board_mode = BOARD_MODE_EAGER;
+    args->jobs = 0;
+    args->tick_ms = 0;
+    args->move_sched = (MoveSchedConfig){.policy = MOVE_SCHED_ROTATION};
+    args->trace_path = NULL;
+    args->results_dir = NULL;
     args->view_path = NULL;
     args->player_count = 0;
 
     int opt;
     bool players_set = false; // Se usa para aceptar solo el primer -p
-    while ((opt = getopt(argc, argv, "w:h:d:t:s:v:p:")) != -1)
+    while ((opt = getopt(argc, argv, "w:h:d:t:s:c:a:S:k:K:r:b:B:l:gj:i:q:T:R:v:p:")) != -1)
     {
         switch (opt)
         {
@@ -495,6 +846,71 @@ static bool parse_args(int argc, char **argv, MasterArgs *args)
         case 's':
             args->seed = atoi(optarg);
             break;
+        case 'c':
+            args->move_credits = atoi(optarg);
+            break;
+        case 'a':
+            if (!sched_ctl_parse_cpus(optarg, &args->pinning))
+            {
+                fprintf(stderr, "Error: Invalid CPU list '%s' (use 'auto' or e.g. 0,2,4).\n", optarg);
+                return false;
+            }
+            break;
+        case 'S':
+            if (!sched_ctl_parse_policy(optarg, &args->sched))
+            {
+                fprintf(stderr, "Error: Invalid scheduling policy '%s' (use fifo:<prio> or nice:<n>).\n", optarg);
+                return false;
+            }
+            break;
+        case 'k':
+            args->checkpoint_path = optarg;
+            break;
+        case 'K':
+            args->checkpoint_interval_ms = atoi(optarg);
+            break;
+        case 'r':
+            args->resume_path = optarg;
+            break;
+        case 'b':
+            args->board_path = optarg;
+            break;
+        case 'B':
+            args->board_dump_path = optarg;
+            break;
+        case 'l':
+            if (!board_layout_parse(optarg, &args->board_layout))
+            {
+                fprintf(stderr, "Error: Unknown board layout '%s' (use rowmajor or tiled).\n", optarg);
+                return false;
+            }
+            break;
+        case 'g':
+            args->board_mode = BOARD_MODE_PROCEDURAL;
+            break;
+        case 'j':
+            if (!parse_jobs(optarg, &args->jobs))
+            {
+                fprintf(stderr, "Error: Move application jobs (-j) must be a number between 1 and %d.\n", MAX_MOVE_JOBS);
+                return false;
+            }
+            break;
+        case 'i':
+            args->tick_ms = atoi(optarg);
+            break;
+        case 'q':
+            if (!move_sched_parse(optarg, &args->move_sched))
+            {
+                fprintf(stderr, "Error: Unknown move scheduling policy '%s' (use rotation, fifo, drr[:quantum] or edf[:period_ms]).\n", optarg);
+                return false;
+            }
+            break;
+        case 'T':
+            args->trace_path = optarg;
+            break;
+        case 'R':
+            args->results_dir = optarg;
+            break;
         case 'v':
             args->view_path = optarg;
             break;
@@ -553,6 +969,58 @@ static bool parse_args(int argc, char **argv, MasterArgs *args)
         return false;
     }
 
+    if (args->width > MAX_WIDTH || args->height > MAX_HEIGHT)
+    {
+        fprintf(stderr, "Error: Maximum width and height are %u and %u.\n", MAX_WIDTH, MAX_HEIGHT);
+        return false;
+    }
+
+    if (args->board_mode == BOARD_MODE_PROCEDURAL)
+    {
+        // El tile es la unidad de materialización
+        args->board_layout = BOARD_LAYOUT_TILED;
+        // Un checkpoint copia el segmento entero, que aquí puede ser enorme
+        if (args->checkpoint_path || args->resume_path)
+        {
+            fprintf(stderr, "Error: Checkpoints (-k/-r) are not supported with procedural boards (-g).\n");
+            return false;
+        }
+        if (args->board_dump_path && (unsigned long long)args->width * args->height > MAX_PROCEDURAL_DUMP_CELLS)
+        {
+            fprintf(stderr, "Error: Board dumps (-B) with -g are limited to %llu cells.\n",
+                    (unsigned long long)MAX_PROCEDURAL_DUMP_CELLS);
+            return false;
+        }
+    }
+
+    // El archivo define las recompensas (y las dimensiones) de la partida
+    if (args->board_path && (args->board_mode == BOARD_MODE_PROCEDURAL || args->resume_path))
+    {
+        fprintf(stderr, "Error: Board files (-b) cannot be combined with -g or -r.\n");
+        return false;
+    }
+
+    if (args->move_credits < 1 || args->move_credits > MAX_MOVE_CREDITS)
+    {
+        fprintf(stderr, "Error: Move credits must be between 1 and %d.\n", MAX_MOVE_CREDITS);
+        return false;
+    }
+
+    // Un tick es un movimiento por jugador: con más créditos un plan se
+    // recortaría sin devolverle los créditos del resto
+    if (args->tick_ms > 0 && args->move_credits != 1)
+    {
+        fprintf(stderr, "Error: Tick mode (-i) requires a single move credit (-c 1).\n");
+        return false;
+    }
+
+    // -j e -i atienden a todos los listos juntos: no hay a quién elegir
+    if (args->move_sched.policy != MOVE_SCHED_ROTATION && (args->jobs > 0 || args->tick_ms > 0))
+    {
+        fprintf(stderr, "Error: Move scheduling policies (-q) only apply without -j and -i.\n");
+        return false;
+    }
+
     return true;
 }
 
@@ -574,13 +1042,16 @@ static bool init_game_resources(const MasterArgs *args, GameResources *res)
     sem_init(&res->sync->state_mutex, 1, 1);
     sem_init(&res->sync->readers_count_mutex, 1, 1);
     res->sync->readers_count = 0;
+    atomic_init(&res->sync->state_seq, 0);
+    atomic_init(&res->sync->state_generation, 0);
+    atomic_init(&res->sync->spectator_waiters, 0);
     for (int i = 0; i < args->player_count; i++)
     {
-        sem_init(&res->sync->player_can_move[i], 1, 1); // Cada jugador puede enviar 1 solicitud inicial
+        sem_init(&res->sync->player_can_move[i].sem, 1, args->move_credits); // Ventana de créditos inicial de cada jugador
     }
 
     // Crear memoria compartida para el estado del juego
-    size_t state_size = GAME_STATE_MAP_SIZE(args->width, args->height);
+    size_t state_size = GAME_STATE_MAP_SIZE(args->width, args->height, args->board_layout);
     res->state_shm = create_shm(GAME_STATE_SHM_NAME, state_size, O_RDWR | O_CREAT | O_EXCL, 0666, PROT_READ | PROT_WRITE);
     if (res->state_shm == NULL)
     {
@@ -589,6 +1060,8 @@ static bool init_game_resources(const MasterArgs *args, GameResources *res)
         return false;
     }
     res->state = get_shm_pointer(res->state_shm);
+    // La cabecera debe estar lista antes de lanzar hijos: la usan para mapear
+    game_state_init_header(res->state, args->width, args->height, args->board_layout, args->board_mode, args->seed);
 
     return true;
 }
@@ -600,7 +1073,10 @@ static bool init_resources(const MasterArgs *args, GameResources *res)
     res->player_pipes = (int *)calloc(args->player_count, sizeof(int));
     res->player_pids = (pid_t *)calloc(args->player_count, sizeof(pid_t));
     res->player_statuses = (int *)calloc(args->player_count, sizeof(int));
-    if (!res->player_pipes || !res->player_pids)
+    res->player_cpus = (int *)calloc(args->player_count, sizeof(int));
+    res->master_cpu = -1;
+    res->view_cpu = -1;
+    if (!res->player_pipes || !res->player_pids || !res->player_statuses || !res->player_cpus)
     {
         perror("allocating memory for child resources failed");
         cleanup_game_resources(res, args->player_count);
@@ -611,6 +1087,7 @@ static bool init_resources(const MasterArgs *args, GameResources *res)
     for (int i = 0; i < args->player_count; i++)
     {
         res->player_pipes[i] = -1;
+        res->player_cpus[i] = -1;
     }
 
     if (!init_game_resources(args, res))
@@ -620,6 +1097,41 @@ static bool init_resources(const MasterArgs *args, GameResources *res)
         return false;
     }
 
+    // Las rings de trazas deben existir antes de lanzar a los hijos. Un
+    // segmento que dejó una corrida caída haría fallar la creación exclusiva
+    trace_unlink_stale();
+    if (args->trace_path)
+    {
+        if (!trace_create("master"))
+        {
+            perror("create_shm trace buffer failed");
+            cleanup_game_resources(res, args->player_count);
+            return false;
+        }
+    }
+
+    if (args->jobs > 0 || args->tick_ms > 0)
+    {
+        res->move_batch = move_batch_create(args->jobs > 0 ? args->jobs : 1, game_rules_apply_move);
+        if (res->move_batch == NULL)
+        {
+            perror("creating move application workers failed");
+            cleanup_game_resources(res, args->player_count);
+            return false;
+        }
+    }
+
+    if (args->checkpoint_path)
+    {
+        res->checkpoint = checkpoint_create(args->checkpoint_path, GAME_STATE_MAP_SIZE(args->width, args->height, args->board_layout));
+        if (res->checkpoint == NULL)
+        {
+            perror("creating checkpoint writer failed");
+            cleanup_game_resources(res, args->player_count);
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -630,6 +1142,45 @@ static void print_config(const MasterArgs *args)
     printf("delay: %u\n", args->delay);
     printf("timeout: %u\n", args->timeout);
     printf("seed: %u\n", args->seed);
+    printf("move_credits: %u\n", args->move_credits);
+    printf("board_layout: %s\n", board_layout_name(args->board_layout));
+    printf("board_mode: %s\n", board_mode_name(args->board_mode));
+    if (args->jobs > 0)
+    {
+        printf("jobs: %u\n", args->jobs);
+    }
+    if (args->tick_ms > 0)
+    {
+        printf("tick: %u ms\n", args->tick_ms);
+    }
+    else if (args->jobs == 0)
+    {
+        printf("move_sched: %s\n", move_sched_name(args->move_sched.policy));
+    }
+    if (args->trace_path)
+    {
+        printf("trace: %s\n", args->trace_path);
+    }
+    if (args->results_dir)
+    {
+        printf("results: %s\n", args->results_dir);
+    }
+    if (args->checkpoint_path)
+    {
+        printf("checkpoint: %s every %u ms\n", args->checkpoint_path, args->checkpoint_interval_ms);
+    }
+    if (args->resume_path)
+    {
+        printf("resume: %s\n", args->resume_path);
+    }
+    if (args->board_path)
+    {
+        printf("board_file: %s\n", args->board_path);
+    }
+    if (args->board_dump_path)
+    {
+        printf("board_dump: %s\n", args->board_dump_path);
+    }
     printf("view: %s\n", args->view_path ? args->view_path : "");
     printf("num_players: %d\n", args->player_count);
     for (int i = 0; i < args->player_count; i++)
@@ -638,23 +1189,83 @@ static void print_config(const MasterArgs *args)
     }
 }
 
+// Guarda un checkpoint si pasó el intervalo (o siempre, con force). El master
+// es el único escritor del estado, así que puede copiarlo sin tomar el lock.
+static void save_checkpoint(const MasterArgs *args, GameResources *res, int current_player_turn,
+                            long long last_valid_move_ms, bool force)
+{
+    if (res->checkpoint == NULL)
+    {
+        return;
+    }
+    long long now_ms = monotonic_millis();
+    if (!force && now_ms - res->last_checkpoint_ms < (long long)args->checkpoint_interval_ms)
+    {
+        return;
+    }
+
+    CheckpointMeta meta = {
+        .seed = args->seed,
+        .current_player_turn = (uint32_t)current_player_turn,
+        .ms_since_last_valid_move = now_ms - last_valid_move_ms,
+    };
+    if (res->move_sched)
+    {
+        move_sched_snapshot(res->move_sched, &meta.move_sched);
+    }
+    if (force)
+    {
+        checkpoint_write_now(res->checkpoint, res->state, &meta);
+    }
+    else if (!checkpoint_submit(res->checkpoint, res->state, &meta))
+    {
+        return; // El hilo escritor sigue ocupado: reintentar en la próxima vuelta
+    }
+    res->last_checkpoint_ms = now_ms;
+}
+
+// Espera a un hijo y registra la última CPU en la que corrió antes de cosecharlo
+static int reap_child(pid_t pid, int *out_cpu)
+{
+    siginfo_t info;
+    while (waitid(P_PID, pid, &info, WEXITED | WNOWAIT) == -1 && errno == EINTR)
+        ;
+    *out_cpu = sched_ctl_last_cpu(pid);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+        ;
+    return status;
+}
+
 static void init_game(const MasterArgs *args, GameResources *resources)
 {
+    // El lock de escritor se tomó antes de lanzar a los hijos (ver main)
     init_game_state(args, resources);
+    unlock_writer(resources);
     notify_view(args, resources);
 
+    resources->game_start_ms = monotonic_millis();
     int current_player_turn = 0;
     fd_set read_fds;
     int max_fd = 0;
     long long last_valid_move_ms = monotonic_millis();
+    if (resources->resume_state)
+    {
+        current_player_turn = (int)(resources->resume_meta.current_player_turn % (unsigned int)args->player_count);
+        last_valid_move_ms -= resources->resume_meta.ms_since_last_valid_move;
+    }
+    resources->last_checkpoint_ms = monotonic_millis();
 
     while (!resources->state->finished)
     {
         if (stop_requested)
         {
+            save_checkpoint(args, resources, current_player_turn, last_valid_move_ms, true);
             request_graceful_shutdown(args, resources);
             break;
         }
+        save_checkpoint(args, resources, current_player_turn, last_valid_move_ms, false);
         FD_ZERO(&read_fds);
         max_fd = 0; // Recalcular en cada iteración
         int active_players = 0;
@@ -674,18 +1285,15 @@ static void init_game(const MasterArgs *args, GameResources *resources)
         if (active_players == 0)
         {
             // Adquirir lock de escritor para actualizar el estado final
-            sem_wait(&resources->sync->master_starvation_guard);
-            sem_wait(&resources->sync->state_mutex);
-            sem_post(&resources->sync->master_starvation_guard);
+            lock_writer(resources);
 
             resources->state->finished = true;
 
             // Liberar lock de escritor
-            sem_post(&resources->sync->state_mutex);
+            unlock_writer(resources);
 
             // Notificar a la vista por última vez para que vea finished=true
-            sem_post(&resources->sync->view_update_ready);
-            sem_wait(&resources->sync->view_print_done);
+            notify_view(args, resources);
 
             break;
         }
@@ -701,6 +1309,34 @@ static void init_game(const MasterArgs *args, GameResources *resources)
             break;
         }
 
+        if (args->tick_ms > 0)
+        {
+            int ticked = run_tick(args, resources);
+            if (ticked == -1)
+            {
+                if (errno == EINTR || stop_requested)
+                {
+                    save_checkpoint(args, resources, current_player_turn, last_valid_move_ms, true);
+                    request_graceful_shutdown(args, resources);
+                }
+                else
+                {
+                    perror("select failed");
+                }
+                break;
+            }
+            if (ticked == 1)
+            {
+                last_valid_move_ms = monotonic_millis();
+            }
+            current_player_turn = (int)(resources->ticks % (unsigned long long)args->player_count);
+            if (no_moves_left(args, resources))
+            {
+                finish_game_and_notify(args, resources);
+            }
+            continue;
+        }
+
         struct timeval timeout;
         timeout.tv_sec = (time_t)(remaining_ms / 1000LL);
         timeout.tv_usec = (suseconds_t)((remaining_ms % 1000LL) * 1000LL);
@@ -711,6 +1347,7 @@ static void init_game(const MasterArgs *args, GameResources *resources)
         {
             if (errno == EINTR || stop_requested)
             {
+                save_checkpoint(args, resources, current_player_turn, last_valid_move_ms, true);
                 request_graceful_shutdown(args, resources);
             }
             else
@@ -727,70 +1364,69 @@ static void init_game(const MasterArgs *args, GameResources *resources)
             break;
         }
 
-        // Lógica de Round-Robin
-        for (int i = 0; i < args->player_count; i++)
+        if (resources->move_batch)
         {
-            int player_idx = (current_player_turn + i) % args->player_count;
-            int player_pipe = resources->player_pipes[player_idx];
-
-            if (FD_ISSET(player_pipe, &read_fds))
+            // Un lote por ronda; la prioridad ante conflictos rota con el turno
+            if (process_move_batch(&read_fds, current_player_turn, args, resources))
             {
-                // Procesar movimiento
-                // Capturar conteos previos para detectar si fue válido
-                unsigned int prev_valid = resources->state->players[player_idx].valid_move_requests;
-                process_player_move(player_idx, player_pipe, args, resources);
-
-                // Si hubo un movimiento válido, actualizar reloj
-                if (resources->state->players[player_idx].valid_move_requests > prev_valid)
-                {
-                    last_valid_move_ms = monotonic_millis();
-                }
-
-                // Recalcular jugadores activos después de procesar el movimiento
-                int remaining_active = 0;
-                for (int p = 0; p < args->player_count; p++)
-                {
-                    if (!resources->state->players[p].blocked && resources->player_pipes[p] != -1)
-                    {
-                        remaining_active++;
-                    }
-                }
-
-                if (remaining_active == 0)
-                {
-                    // Adquirir lock de escritor para actualizar el estado final y notificar
-                    finish_game_and_notify(args, resources);
-
-                    break; // salir del for y luego del while por la condición
-                }
+                last_valid_move_ms = monotonic_millis();
+            }
+            current_player_turn = (current_player_turn + 1) % args->player_count;
+            if (no_moves_left(args, resources))
+            {
+                finish_game_and_notify(args, resources);
+            }
+            continue;
+        }
 
-                // Finalizar si ningún jugador puede moverse
-                if (!any_player_can_move(resources->state))
-                {
-                    finish_game_and_notify(args, resources);
-                    break;
-                }
+        // Se atiende a un único jugador por select; cuál, lo decide -q
+        bool ready[MAX_PLAYERS] = {false};
+        for (int i = 0; i < args->player_count; i++)
+        {
+            int player_pipe = resources->player_pipes[i];
+            ready[i] = player_pipe != -1 && FD_ISSET(player_pipe, &read_fds);
+        }
+        move_sched_observe(resources->move_sched, ready);
+        int player_idx = move_sched_pick(resources->move_sched);
+        if (player_idx >= 0)
+        {
+            // Capturar conteos previos para detectar si fue válido
+            const Player *player = &resources->state->players[player_idx];
+            unsigned int prev_valid = player->valid_move_requests;
+            unsigned int prev_total = prev_valid + player->invalid_move_requests;
+            process_player_move(player_idx, resources->player_pipes[player_idx], args, resources);
+            move_sched_served(resources->move_sched, player_idx,
+                              player->valid_move_requests + player->invalid_move_requests - prev_total);
+            current_player_turn = move_sched_turn(resources->move_sched);
+
+            // Si hubo un movimiento válido, actualizar reloj
+            if (player->valid_move_requests > prev_valid)
+            {
+                last_valid_move_ms = monotonic_millis();
+            }
 
-                // Avanzar al siguiente jugador para la próxima ronda
-                current_player_turn = (player_idx + 1) % args->player_count;
-                break; // Procesar solo un jugador por iteración de select
+            if (no_moves_left(args, resources))
+            {
+                finish_game_and_notify(args, resources);
             }
         }
     }
 
+    resources->game_end_ms = monotonic_millis();
+
+    // Despertar a los jugadores que esperan créditos para que vean finished
+    wake_all_players(args, resources);
+
+    resources->master_cpu = sched_ctl_last_cpu(0);
     if (resources->view_pid > 0)
     {
-        int status;
-        waitpid(resources->view_pid, &status, 0);
-        resources->view_status = status;
+        resources->view_status = reap_child(resources->view_pid, &resources->view_cpu);
     }
     for (int i = 0; i < args->player_count; i++)
     {
         if (resources->player_pids[i] > 0)
         {
-            int status;
-            waitpid(resources->player_pids[i], &status, 0);
-            resources->player_statuses[i] = status;
+            resources->player_statuses[i] = reap_child(resources->player_pids[i], &resources->player_cpus[i]);
         }
     }
 }
@@ -806,16 +1442,113 @@ int main(int argc, char **argv)
     sa.sa_handler = handle_sigint_master;
     sigaction(SIGINT, &sa, NULL);
 
+    // Reanudar: dimensiones y créditos salen del checkpoint
+    GameState *resume_state = NULL;
+    CheckpointMeta resume_meta = {0};
+    if (args.resume_path)
+    {
+        size_t resume_size;
+        if (!checkpoint_load(args.resume_path, &resume_meta, &resume_state, &resume_size))
+        {
+            return EXIT_FAILURE;
+        }
+        if ((int)resume_state->player_count != args.player_count)
+        {
+            fprintf(stderr, "Error: Checkpoint has %u players but %d were given with -p.\n",
+                    resume_state->player_count, args.player_count);
+            free(resume_state);
+            return EXIT_FAILURE;
+        }
+        args.width = resume_state->width;
+        args.height = resume_state->height;
+        args.move_credits = resume_state->move_credits;
+        args.board_layout = (BoardLayout)resume_state->board_layout;
+        args.seed = resume_meta.seed;
+
+        // La política de -q (y su estado) también sale del checkpoint
+        MoveSchedConfig saved = {.policy = (MoveSchedPolicy)resume_meta.move_sched.policy,
+                                 .param = resume_meta.move_sched.param};
+        const char *problem = NULL;
+        if (resume_meta.move_sched.policy > MOVE_SCHED_EDF)
+            problem = "has an unknown move scheduling policy";
+        else if (args.move_sched.policy != MOVE_SCHED_ROTATION &&
+                 (args.move_sched.policy != saved.policy || args.move_sched.param != saved.param))
+            problem = "was taken with a different -q policy";
+        else if (saved.policy != MOVE_SCHED_ROTATION && (args.jobs > 0 || args.tick_ms > 0))
+            problem = "uses a -q policy, which does not apply with -j or -i";
+        if (problem)
+        {
+            fprintf(stderr, "Error: Checkpoint %s (%s).\n", problem, move_sched_name(saved.policy));
+            free(resume_state);
+            return EXIT_FAILURE;
+        }
+        args.move_sched = saved;
+    }
+
+    // Tablero desde archivo: las dimensiones salen de su cabecera
+    BoardFileADT board_file = NULL;
+    if (args.board_path)
+    {
+        board_file = board_file_open(args.board_path);
+        if (board_file == NULL)
+        {
+            return EXIT_FAILURE;
+        }
+        args.width = board_file_width(board_file);
+        args.height = board_file_height(board_file);
+        if (args.width < MIN_WIDTH || args.height < MIN_HEIGHT)
+        {
+            fprintf(stderr, "Error: Board file is %ux%u; minimum width and height are %d and %d.\n",
+                    args.width, args.height, MIN_WIDTH, MIN_HEIGHT);
+            board_file_close(board_file);
+            return EXIT_FAILURE;
+        }
+        if (board_file_max_owner(board_file) >= args.player_count)
+        {
+            fprintf(stderr, "Error: Board file has trails of player %d but only %d players were given with -p.\n",
+                    board_file_max_owner(board_file), args.player_count);
+            board_file_close(board_file);
+            return EXIT_FAILURE;
+        }
+    }
+
     print_config(&args);
 
+    sched_ctl_apply_self("master", sched_ctl_cpu_for_slot(&args.pinning, SCHED_CTL_SLOT_MASTER), &args.sched);
+
     GameResources resources;
     if (!init_resources(&args, &resources))
     {
+        free(resume_state);
+        board_file_close(board_file);
         return EXIT_FAILURE;
     }
+    resources.resume_state = resume_state;
+    resources.resume_meta = resume_meta;
+    resources.board_file = board_file;
+
+    if (args.jobs == 0 && args.tick_ms == 0)
+    {
+        int first_turn = resume_state ? (int)(resume_meta.current_player_turn % (unsigned int)args.player_count) : 0;
+        resources.move_sched = move_sched_create(&args.move_sched, args.player_count, args.move_credits, first_turn);
+        if (resources.move_sched == NULL)
+        {
+            perror("creating the move scheduler failed");
+            cleanup_game_resources(&resources, args.player_count);
+            return EXIT_FAILURE;
+        }
+        if (resume_state)
+        {
+            move_sched_restore(resources.move_sched, &resume_meta.move_sched);
+        }
+    }
 
+    // Los jugadores buscan su PID apenas arrancan: mantener el lock de escritor
+    // hasta que init_game_state haya publicado PIDs y posiciones.
+    lock_writer(&resources);
     if (!launch_children(&args, &resources))
     {
+        unlock_writer(&resources);
         fprintf(stderr, "Error: Child processes could not be launched.\n");
         cleanup_game_resources(&resources, args.player_count);
         return EXIT_FAILURE;
@@ -824,6 +1557,30 @@ int main(int argc, char **argv)
     init_game(&args, &resources);
 
     print_finish_status(&args, &resources);
+    print_game_stats(&args, &resources);
+    if (resources.move_sched)
+    {
+        move_sched_print_report(resources.move_sched,
+                                (double)(resources.game_end_ms - resources.game_start_ms) / 1000.0);
+    }
+    print_cpu_report(&args, &resources);
+    if (args.results_dir)
+    {
+        record_results(&args, &resources);
+    }
+    if (args.board_dump_path)
+    {
+        if (board_file_save(args.board_dump_path, resources.state))
+            printf("Board written to %s\n", args.board_dump_path);
+    }
+    if (args.trace_path)
+    {
+        // Los hijos ya terminaron: las rings no cambian más
+        if (trace_dump(args.trace_path))
+            printf("Trace written to %s\n", args.trace_path);
+        else
+            fprintf(stderr, "Error: Could not write trace to '%s': %s\n", args.trace_path, strerror(errno));
+    }
 
     cleanup_game_resources(&resources, args.player_count);
     return 0;
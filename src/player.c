@@ -8,8 +8,11 @@
 #include <unistd.h>
 #include <semaphore.h>
 #include "game_state.h"
+#include "board.h"
+#include "game_rules.h"
 #include "game_sync.h"
 #include "shmADT.h"
+#include "trace.h"
 
 static bool find_player_index_by_pid(const GameState *state, GameSync *sync,
                                      pid_t pid, unsigned *out_index,
@@ -21,7 +24,7 @@ static bool find_player_index_by_pid(const GameState *state, GameSync *sync,
     player_count_snapshot = MAX_PLAYERS;
   for (unsigned i = 0; i < player_count_snapshot; i++)
   {
-    if (state->players[i].pid == pid)
+    if (state->player_info[i].pid == pid)
     {
       bool finished_snapshot = state->finished;
       game_sync_reader_exit(sync);
@@ -55,10 +58,18 @@ typedef struct
 
 static bool parse_args(int argc, char **argv, PlayerArgs *out_args)
 {
+  // width/height se aceptan por compatibilidad con el master, pero el mapeo
+  // se dimensiona a partir de la cabecera del segmento
+  if (argc == 1)
+  {
+    out_args->width = 0;
+    out_args->height = 0;
+    return true;
+  }
   if (argc != 3)
   {
     errno = EINVAL;
-    fprintf(stderr, "player: invalid usage. Usage: %s <width> <height>\n", argv[0]);
+    fprintf(stderr, "player: invalid usage. Usage: %s [<width> <height>]\n", argv[0]);
     return false;
   }
 
@@ -77,17 +88,12 @@ static bool parse_args(int argc, char **argv, PlayerArgs *out_args)
 
 static bool init_resources(const PlayerArgs *args, PlayerResources *out_res)
 {
-  size_t map_size = GAME_STATE_MAP_SIZE(args->width, args->height);
-
-  out_res->state_shm = open_shm(GAME_STATE_SHM_NAME, map_size, O_RDONLY, 0600, PROT_READ);
+  (void)args; // las dimensiones se toman de la cabecera del segmento
+  out_res->state_shm = game_state_open("player", &out_res->state);
   if (out_res->state_shm == NULL)
   {
-    fprintf(stderr,
-            "player: failed to open shm '%s' (read-only, size=%zu): %s\n",
-            GAME_STATE_SHM_NAME, map_size, strerror(errno));
     return false;
   }
-  out_res->state = (GameState *)get_shm_pointer(out_res->state_shm);
 
   out_res->sync_shm = open_shm(GAME_SYNC_SHM_NAME, sizeof(GameSync), O_RDWR, 0600, PROT_READ | PROT_WRITE);
   if (out_res->sync_shm == NULL)
@@ -113,6 +119,105 @@ static void cleanup_resources(PlayerResources *res)
     close_shm(res->state_shm);
 }
 
+// Movimientos enviados cuyo crédito todavía no volvió y la celda a la que
+// lleva cada uno si sale bien. El master devuelve los créditos de cada
+// solicitud después de aplicarla, en el orden en que llegaron.
+typedef struct
+{
+  unsigned count;
+  unsigned first;
+  int x[MAX_MOVE_CREDITS];
+  int y[MAX_MOVE_CREDITS];
+} InFlight;
+
+// Espera hasta tener want créditos en mano y después recoge, sin esperar, los
+// que ya hayan vuelto. En *returned deja cuántos volvieron en total.
+// Devuelve false si hubo un error.
+static bool collect_credits(GameSync *sync, unsigned me, unsigned *held, unsigned want, unsigned *returned)
+{
+  unsigned got = 0;
+  TRACE_BEGIN(TRACE_CREDIT_WAIT);
+  while (*held + got < want)
+  {
+    if (sem_wait(&sync->player_can_move[me].sem) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "player: error in sem_wait(player_can_move[%u]): %s\n", me, strerror(errno));
+      TRACE_END(TRACE_CREDIT_WAIT);
+      return false;
+    }
+    got++;
+  }
+  TRACE_END(TRACE_CREDIT_WAIT);
+  while (sem_trywait(&sync->player_can_move[me].sem) == 0)
+    got++;
+  *held += got;
+  *returned = got;
+  return true;
+}
+
+// La posición actual tiene que ser la última confirmada o alguna de las que
+// están en vuelo (el master pudo aplicarlas sin haber devuelto el crédito
+// todavía); si no, algo de lo enviado salió inválido.
+static bool in_flight_matches(const InFlight *f, int confirmed_x, int confirmed_y, int x, int y)
+{
+  if (x == confirmed_x && y == confirmed_y)
+    return true;
+  for (unsigned k = 0; k < f->count; k++)
+  {
+    unsigned i = (f->first + k) % MAX_MOVE_CREDITS;
+    if (f->x[i] == x && f->y[i] == y)
+      return true;
+  }
+  return false;
+}
+
+// Planifica de forma golosa hasta max_len pasos desde (x, y) sobre el estado
+// actual (llamar con el lock de lectura tomado). Las primeras taken celdas de
+// cells_x/cells_y no se pisan (son las que ya están en vuelo); las del plan
+// se agregan a continuación. Devuelve la longitud del plan.
+static unsigned plan_greedy_path(const GameState *state, int x, int y, int *cells_x, int *cells_y,
+                                 unsigned taken, unsigned char *plan, unsigned max_len)
+{
+  unsigned len = 0;
+
+  while (len < max_len)
+  {
+    int chosen_dir = -1;
+    int bestv = -1;
+    for (int d = 0; d < 8; d++)
+    {
+      int nx = x + GAME_DIR_DX[d];
+      int ny = y + GAME_DIR_DY[d];
+      if (!board_in_bounds(state, nx, ny))
+        continue;
+      bool already_planned = false;
+      for (unsigned k = 0; k < taken + len; k++)
+      {
+        if (cells_x[k] == nx && cells_y[k] == ny)
+          already_planned = true;
+      }
+      int v = board_get(state, nx, ny);
+      if (!already_planned && v >= 1 && v <= 9 && v > bestv)
+      {
+        bestv = v;
+        chosen_dir = d;
+      }
+    }
+
+    if (chosen_dir < 0)
+      break;
+
+    x += GAME_DIR_DX[chosen_dir];
+    y += GAME_DIR_DY[chosen_dir];
+    cells_x[taken + len] = x;
+    cells_y[taken + len] = y;
+    plan[len++] = (unsigned char)chosen_dir;
+  }
+  return len;
+}
+
 static void run_player_loop(GameState *state, GameSync *sync)
 {
   pid_t mypid = getpid();
@@ -132,74 +237,107 @@ static void run_player_loop(GameState *state, GameSync *sync)
     return;
   }
 
-  // Direcciones relativas para 8 vecinos
-  static const int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-  static const int DY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+  // La ventana de créditos la fija el master y no cambia durante la partida
+  unsigned max_credits = state->move_credits;
+  if (max_credits < 1)
+    max_credits = 1;
+  if (max_credits > MAX_MOVE_CREDITS)
+    max_credits = MAX_MOVE_CREDITS;
+
+  // Planes de a lo sumo media ventana: mientras el master aplica uno, el
+  // siguiente ya espera en el pipe
+  unsigned chunk = (max_credits + 1) / 2;
+  unsigned held = 0;
+  InFlight flight = {0};
+  int confirmed_x = 0, confirmed_y = 0; // donde quedó el último movimiento con crédito devuelto
+  bool resync = false; // algo en vuelo salió mal: esperar la ventana entera
 
   while (true)
   {
-    if (sem_wait(&sync->player_can_move[me]) == -1)
-    {
-      if (errno == EINTR)
-        continue;
-      fprintf(stderr, "player: error in sem_wait(player_can_move[%u]): %s\n", me, strerror(errno));
+    unsigned returned;
+    if (!collect_credits(sync, me, &held, resync ? max_credits : chunk, &returned))
       break;
+    for (; returned > 0 && flight.count > 0; returned--)
+    {
+      confirmed_x = flight.x[flight.first];
+      confirmed_y = flight.y[flight.first];
+      flight.first = (flight.first + 1) % MAX_MOVE_CREDITS;
+      flight.count--;
     }
 
-    // Snapshot mínimo bajo lock de lectura
-    unsigned short width_snapshot = 0, height_snapshot = 0;
-    unsigned short x_snapshot = 0, y_snapshot = 0;
-    int neighbor_vals[8];
-    unsigned char neighbor_ok_mask = 0;
+    // Planificar bajo lock de lectura, desde donde termina lo que está en vuelo
+    unsigned char msg[1 + MAX_MOVE_CREDITS];
+    int cells_x[2 * MAX_MOVE_CREDITS], cells_y[2 * MAX_MOVE_CREDITS];
+    unsigned plan_len = 0;
+    unsigned max_len = held < chunk ? held : chunk;
 
+    TRACE_BEGIN(TRACE_PLAYER_THINK);
     game_sync_reader_enter(sync);
     finished_now = state->finished;
     if (!finished_now)
     {
-      width_snapshot = state->width;
-      height_snapshot = state->height;
-      x_snapshot = state->players[me].x;
-      y_snapshot = state->players[me].y;
-      for (int d = 0; d < 8; d++)
+      int x = (int)state->players[me].x;
+      int y = (int)state->players[me].y;
+      if (flight.count == 0)
       {
-        int nx = (int)x_snapshot + DX[d];
-        int ny = (int)y_snapshot + DY[d];
-        if (nx >= 0 && ny >= 0 && nx < (int)width_snapshot && ny < (int)height_snapshot)
+        resync = false;
+        confirmed_x = x;
+        confirmed_y = y;
+      }
+      else if (!in_flight_matches(&flight, confirmed_x, confirmed_y, x, y))
+        resync = true;
+      if (!resync)
+      {
+        for (unsigned k = 0; k < flight.count; k++)
         {
-          neighbor_ok_mask |= (1u << d);
-          neighbor_vals[d] = state->board[ny * (int)width_snapshot + nx];
+          unsigned i = (flight.first + k) % MAX_MOVE_CREDITS;
+          cells_x[k] = x = flight.x[i];
+          cells_y[k] = y = flight.y[i];
         }
+        plan_len = plan_greedy_path(state, x, y, cells_x, cells_y, flight.count, msg + 1, max_len);
       }
     }
     game_sync_reader_exit(sync);
+    TRACE_END(TRACE_PLAYER_THINK);
 
     if (finished_now)
       break;
+    if (resync)
+      continue;
 
-    // Calcular la mejor dirección fuera del lock
-    int chosen_dir = -1;
-    int bestv = -1;
-    for (int d = 0; d < 8; d++)
+    if (plan_len == 0)
     {
-      if (((neighbor_ok_mask >> d) & 1u) == 0)
-        continue;
-      int v = neighbor_vals[d];
-      if (v >= 1 && v <= 9 && v > bestv)
+      // Lo que está en vuelo puede no salir: decidir con el estado al día
+      if (flight.count > 0)
       {
-        bestv = v;
-        chosen_dir = d;
+        resync = true;
+        continue;
       }
+      close(STDOUT_FILENO);
+      break;
     }
 
-    if (chosen_dir < 0)
+    held -= plan_len;
+    for (unsigned k = 0; k < plan_len; k++)
     {
-      close(STDOUT_FILENO);
-      break;
+      unsigned i = (flight.first + flight.count) % MAX_MOVE_CREDITS;
+      flight.x[i] = cells_x[flight.count];
+      flight.y[i] = cells_y[flight.count];
+      flight.count++;
+    }
+
+    // Un solo paso se envía con el protocolo de 1 byte de siempre
+    const unsigned char *out = msg + 1;
+    size_t out_len = 1;
+    if (plan_len > 1)
+    {
+      msg[0] = (unsigned char)(MOVE_PLAN_FLAG | plan_len);
+      out = msg;
+      out_len = 1 + plan_len;
     }
 
-    unsigned char dir = (unsigned char)chosen_dir;
-    ssize_t w = write(STDOUT_FILENO, &dir, 1);
-    if (w != 1)
+    ssize_t w = write(STDOUT_FILENO, out, out_len);
+    if (w != (ssize_t)out_len)
     {
       if (errno != 0)
         fprintf(stderr, "player: failed to write direction to stdout (pid=%d): %s\n", (int)mypid, strerror(errno));
@@ -225,6 +363,7 @@ int main(int argc, char **argv)
     return 1;
   }
 
+  trace_attach("player");
   run_player_loop(res.state, res.sync);
 
   cleanup_resources(&res);
@@ -0,0 +1,258 @@
+#define _POSIX_C_SOURCE 200809L // para getopt
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "results_store.h"
+
+// Agregados sobre un almacén de resultados (master -R): por binario, partidas,
+// victorias, distribución de puntajes y salidas anormales. Cada columna se
+// recorre una sola vez sobre el mmap, sin copiar filas.
+
+#define PERCENTILE_COUNT 3
+static const unsigned int PERCENTILES[PERCENTILE_COUNT] = {50, 90, 99};
+
+typedef struct
+{
+    const char *dir;
+    const char *binary; // NULL = todos
+    unsigned int players; // 0 = cualquiera
+    unsigned int width;
+    unsigned int height;
+    unsigned int buckets; // -H: histograma de puntajes (0 = no)
+} QueryArgs;
+
+typedef struct
+{
+    uint64_t rows;
+    uint64_t wins; // rank 1, empates incluidos
+    uint64_t score_sum;
+    uint64_t valid_sum;
+    uint64_t invalid_sum;
+    uint64_t duration_sum;
+    uint64_t crashed; // terminados por señal o con código distinto de 0
+    uint64_t offset;  // inicio de sus puntajes en el arreglo común
+    uint64_t filled;
+} BinaryAgg;
+
+static void print_usage(const char *exec_name)
+{
+    fprintf(stderr, "Usage: %s -d results_dir [-b binary] [-n players] [-w width] [-h height] [-H buckets]\n",
+            exec_name);
+}
+
+static bool parse_args(int argc, char **argv, QueryArgs *args)
+{
+    *args = (QueryArgs){0};
+    int opt;
+    while ((opt = getopt(argc, argv, "d:b:n:w:h:H:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            args->dir = optarg;
+            break;
+        case 'b':
+            args->binary = optarg;
+            break;
+        case 'n':
+            args->players = atoi(optarg);
+            break;
+        case 'w':
+            args->width = atoi(optarg);
+            break;
+        case 'h':
+            args->height = atoi(optarg);
+            break;
+        case 'H':
+            args->buckets = atoi(optarg);
+            break;
+        default:
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    if (args->dir == NULL)
+    {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+// Radix sort LSD de 8 bits: lineal, para no pagar qsort con millones de filas
+static void sort_scores(uint32_t *v, uint32_t *tmp, uint64_t n)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint64_t count[257] = {0};
+        for (uint64_t i = 0; i < n; i++)
+            count[((v[i] >> shift) & 0xFF) + 1]++;
+        if (count[1] == n)
+            continue; // todos con el mismo byte: la pasada no cambia nada
+        for (int b = 0; b < 256; b++)
+            count[b + 1] += count[b];
+        for (uint64_t i = 0; i < n; i++)
+            tmp[count[(v[i] >> shift) & 0xFF]++] = v[i];
+        memcpy(v, tmp, n * sizeof(uint32_t));
+    }
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint64_t n, unsigned int p)
+{
+    // Rango más cercano
+    uint64_t rank = (n * p + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void print_histogram(const char *name, const uint32_t *sorted, uint64_t n, uint32_t max_score,
+                            unsigned int buckets)
+{
+    printf("\n%s score distribution:\n", name);
+    uint64_t width = ((uint64_t)max_score + buckets) / buckets;
+    uint64_t i = 0;
+    for (unsigned int b = 0; b < buckets; b++)
+    {
+        uint64_t hi = (b + 1) * width;
+        uint64_t count = 0;
+        while (i < n && sorted[i] < hi)
+        {
+            i++;
+            count++;
+        }
+        int bar = n > 0 ? (int)(count * 50 / n) : 0;
+        printf("  [%6llu, %6llu) %10llu %5.1f%% %.*s\n", (unsigned long long)(b * width), (unsigned long long)hi,
+               (unsigned long long)count, n > 0 ? 100.0 * (double)count / (double)n : 0.0, bar,
+               "##################################################");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QueryArgs args;
+    if (!parse_args(argc, argv, &args))
+        return EXIT_FAILURE;
+
+    ResultsTable t;
+    if (!results_open(args.dir, &t))
+        return EXIT_FAILURE;
+
+    // El filtro por binario se resuelve una vez contra el diccionario
+    uint32_t binary_filter = UINT32_MAX;
+    if (args.binary)
+    {
+        for (uint32_t i = 0; i < t.binary_count && binary_filter == UINT32_MAX; i++)
+            if (strcmp(t.binaries[i], args.binary) == 0)
+                binary_filter = i;
+        if (binary_filter == UINT32_MAX)
+        {
+            fprintf(stderr, "results_query: binary '%s' does not appear in '%s'\n", args.binary, args.dir);
+            results_close(&t);
+            return EXIT_FAILURE;
+        }
+    }
+
+    BinaryAgg *agg = calloc(t.binary_count + 1, sizeof(BinaryAgg));
+    uint8_t *match = malloc(t.rows + 1);
+    if (agg == NULL || match == NULL)
+    {
+        fprintf(stderr, "results_query: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    const uint8_t *players = results_u8(&t, RESULTS_COL_PLAYERS);
+    const uint8_t *rank = results_u8(&t, RESULTS_COL_RANK);
+    const uint32_t *width = results_u32(&t, RESULTS_COL_WIDTH);
+    const uint32_t *height = results_u32(&t, RESULTS_COL_HEIGHT);
+    const uint32_t *binary = results_u32(&t, RESULTS_COL_BINARY);
+    const uint32_t *score = results_u32(&t, RESULTS_COL_SCORE);
+    const uint32_t *valid = results_u32(&t, RESULTS_COL_VALID);
+    const uint32_t *invalid = results_u32(&t, RESULTS_COL_INVALID);
+    const uint32_t *duration = results_u32(&t, RESULTS_COL_DURATION_MS);
+    const int32_t *status = results_i32(&t, RESULTS_COL_EXIT_STATUS);
+
+    // Primera pasada: filtro y sumas; los puntajes se copian en la segunda
+    uint64_t matched = 0;
+    uint32_t max_score = 0;
+    for (uint64_t i = 0; i < t.rows; i++)
+    {
+        uint32_t b = binary[i];
+        match[i] = (binary_filter == UINT32_MAX || b == binary_filter) &&
+                   (args.players == 0 || players[i] == args.players) &&
+                   (args.width == 0 || width[i] == args.width) &&
+                   (args.height == 0 || height[i] == args.height) && b < t.binary_count;
+        if (!match[i])
+            continue;
+        BinaryAgg *a = &agg[b];
+        a->rows++;
+        a->wins += rank[i] == 1;
+        a->score_sum += score[i];
+        a->valid_sum += valid[i];
+        a->invalid_sum += invalid[i];
+        a->duration_sum += duration[i];
+        a->crashed += WIFSIGNALED(status[i]) || (WIFEXITED(status[i]) && WEXITSTATUS(status[i]) != 0);
+        if (score[i] > max_score)
+            max_score = score[i];
+        matched++;
+    }
+
+    uint32_t *scores = malloc((matched + 1) * sizeof(uint32_t));
+    uint32_t *tmp = malloc((matched + 1) * sizeof(uint32_t));
+    if (scores == NULL || tmp == NULL)
+    {
+        fprintf(stderr, "results_query: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    uint64_t offset = 0;
+    for (uint32_t b = 0; b < t.binary_count; b++)
+    {
+        agg[b].offset = offset;
+        offset += agg[b].rows;
+    }
+    for (uint64_t i = 0; i < t.rows; i++)
+    {
+        if (match[i])
+        {
+            BinaryAgg *a = &agg[binary[i]];
+            scores[a->offset + a->filled++] = score[i];
+        }
+    }
+
+    printf("%llu games, %llu player results, %llu matching\n", (unsigned long long)t.games,
+           (unsigned long long)t.rows, (unsigned long long)matched);
+    printf("%-32s %10s %10s %6s %9s", "binary", "games", "wins", "win%", "mean");
+    for (int p = 0; p < PERCENTILE_COUNT; p++)
+        printf("   p%-3u", PERCENTILES[p]);
+    printf(" %7s %9s %9s %8s %8s\n", "max", "valid", "invalid", "crashed", "avg_ms");
+    for (uint32_t b = 0; b < t.binary_count; b++)
+    {
+        BinaryAgg *a = &agg[b];
+        if (a->rows == 0)
+            continue;
+        uint32_t *s = scores + a->offset;
+        sort_scores(s, tmp, a->rows);
+        double n = (double)a->rows;
+        printf("%-32s %10llu %10llu %5.1f%% %9.1f", t.binaries[b], (unsigned long long)a->rows,
+               (unsigned long long)a->wins, 100.0 * (double)a->wins / n, (double)a->score_sum / n);
+        for (int p = 0; p < PERCENTILE_COUNT; p++)
+            printf(" %6u", percentile(s, a->rows, PERCENTILES[p]));
+        printf(" %7u %9.1f %9.1f %8llu %8.0f\n", s[a->rows - 1], (double)a->valid_sum / n,
+               (double)a->invalid_sum / n, (unsigned long long)a->crashed, (double)a->duration_sum / n);
+    }
+
+    if (args.buckets > 0)
+    {
+        for (uint32_t b = 0; b < t.binary_count; b++)
+            if (agg[b].rows > 0)
+                print_histogram(t.binaries[b], scores + agg[b].offset, agg[b].rows, max_score, args.buckets);
+    }
+
+    free(tmp);
+    free(scores);
+    free(match);
+    free(agg);
+    results_close(&t);
+    return EXIT_SUCCESS;
+}
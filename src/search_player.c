@@ -0,0 +1,348 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <semaphore.h>
+
+#include "constants.h"
+#include "endgame.h"
+#include "game_state.h"
+#include "game_sync.h"
+#include "shmADT.h"
+#include "search.h"
+#include "trace.h"
+
+// Jugador con búsqueda: copia una ventana del tablero bajo el lock de lectura,
+// lo suelta y busca sobre la copia con profundización iterativa hasta agotar
+// el presupuesto por movimiento. Envía siempre un único paso: el resto del
+// plan depende de lo que hagan los rivales mientras tanto.
+//
+// Salvo cuando su región queda sellada (ver endgame.h): ahí nadie más puede
+// tocar sus celdas, así que el camino del solver vale entero y se juega en
+// planes de media ventana de créditos, enviando el siguiente mientras el
+// master aplica el anterior, sin volver a buscar mientras la cabeza siga sobre
+// el camino. Un camino que no es óptimo demostrado se vuelve a resolver en
+// cada turno por si mejora.
+//
+// Se configura por entorno porque el master sólo le pasa width y height:
+//   SEARCH_BUDGET_MS   tiempo de búsqueda por movimiento (por defecto 20)
+//   SEARCH_MAX_DEPTH   tope de profundidad en capas (por defecto 64)
+//   SEARCH_THREADS     hilos de búsqueda (por defecto 1)
+//   SEARCH_TT_MB       memoria de la tabla de transposición (por defecto 16; 0 = sin tabla)
+
+typedef struct
+{
+  ShmADT state_shm;
+  GameState *state;
+  ShmADT sync_shm;
+  GameSync *sync;
+} SearchPlayerResources;
+
+typedef struct
+{
+  unsigned long long moves;
+  unsigned long long depth_sum;
+  unsigned long long nodes;
+  unsigned long long tt_hits;
+  unsigned long long exact;
+  unsigned long long endgame_moves;
+  unsigned long long endgame_solved; // regiones selladas resueltas exactas
+} SearchStats;
+
+// Camino del final en curso y cuánto de él ya se envió
+typedef struct
+{
+  bool active;
+  EndgamePlan plan;
+  unsigned next;
+  int start_x, start_y;
+} EndgameState;
+
+static bool find_player_index_by_pid(const GameState *state, GameSync *sync, pid_t pid, unsigned *out_index,
+                                     bool *out_finished_now)
+{
+  bool found = false;
+  game_sync_reader_enter(sync);
+  unsigned count = state->player_count < MAX_PLAYERS ? state->player_count : MAX_PLAYERS;
+  for (unsigned i = 0; i < count && !found; i++)
+  {
+    if (state->player_info[i].pid == pid)
+    {
+      *out_index = i;
+      found = true;
+    }
+  }
+  *out_finished_now = state->finished;
+  game_sync_reader_exit(sync);
+  return found;
+}
+
+static bool init_resources(SearchPlayerResources *out_res)
+{
+  out_res->state_shm = game_state_open("search_player", &out_res->state);
+  if (out_res->state_shm == NULL)
+    return false;
+
+  out_res->sync_shm = open_shm(GAME_SYNC_SHM_NAME, sizeof(GameSync), O_RDWR, 0600, PROT_READ | PROT_WRITE);
+  if (out_res->sync_shm == NULL)
+  {
+    fprintf(stderr, "search_player: failed to open shm '%s' (read/write, size=%zu): %s\n", GAME_SYNC_SHM_NAME,
+            sizeof(GameSync), strerror(errno));
+    close_shm(out_res->state_shm);
+    return false;
+  }
+  out_res->sync = get_shm_pointer(out_res->sync_shm);
+  return true;
+}
+
+static void cleanup_resources(SearchPlayerResources *res)
+{
+  // El master desvincula los segmentos; aquí sólo se cierran los mapeos
+  if (res->sync_shm)
+    close_shm(res->sync_shm);
+  if (res->state_shm)
+    close_shm(res->state_shm);
+}
+
+// Espera hasta tener want créditos en mano y después recoge, sin esperar, los
+// que ya hayan vuelto (ver player.c). Devuelve false si hubo un error.
+static bool collect_credits(GameSync *sync, unsigned me, unsigned *held, unsigned want, unsigned *returned)
+{
+  unsigned got = 0;
+  TRACE_BEGIN(TRACE_CREDIT_WAIT);
+  while (*held + got < want)
+  {
+    if (sem_wait(&sync->player_can_move[me].sem) == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "search_player: error in sem_wait(player_can_move[%u]): %s\n", me, strerror(errno));
+      TRACE_END(TRACE_CREDIT_WAIT);
+      return false;
+    }
+    got++;
+  }
+  TRACE_END(TRACE_CREDIT_WAIT);
+  while (sem_trywait(&sync->player_can_move[me].sem) == 0)
+    got++;
+  *held += got;
+  *returned = got;
+  return true;
+}
+
+// Los pasos del plan que tocan ahora, si la cabeza está sobre el camino: en
+// el último paso con crédito devuelto o en alguno de los in_flight enviados
+// después, que el master pudo aplicar sin haber devuelto el crédito todavía
+static unsigned take_plan_steps(EndgameState *eg, const SearchPosition *pos, unsigned in_flight, unsigned credits,
+                                unsigned char *out)
+{
+  if (!eg->active || eg->next >= (unsigned)eg->plan.len)
+    return 0;
+  int head = pos->head[pos->me];
+  int x = pos->x0 + head % SEARCH_STRIDE - 1;
+  int y = pos->y0 + head / SEARCH_STRIDE - 1;
+  bool on_path = false;
+  for (int step = (int)eg->next - 1; step >= (int)eg->next - 1 - (int)in_flight && step >= -1 && !on_path; step--)
+  {
+    int want_x = step < 0 ? eg->start_x : eg->plan.x[step];
+    int want_y = step < 0 ? eg->start_y : eg->plan.y[step];
+    on_path = x == want_x && y == want_y;
+  }
+  if (!on_path)
+    return 0;
+  unsigned len = 0;
+  while (len < credits && eg->next < (unsigned)eg->plan.len)
+    out[len++] = eg->plan.moves[eg->next++];
+  return len;
+}
+
+static bool solve_endgame(EndgameADT solver, EndgameState *eg, const SearchPosition *pos, unsigned budget_ms,
+                          SearchStats *stats)
+{
+  eg->active = endgame_solve(solver, pos, budget_ms, &eg->plan);
+  if (!eg->active)
+    return false;
+  int head = pos->head[pos->me];
+  eg->start_x = pos->x0 + head % SEARCH_STRIDE - 1;
+  eg->start_y = pos->y0 + head / SEARCH_STRIDE - 1;
+  eg->next = 0;
+  stats->endgame_solved += eg->plan.exact;
+  return true;
+}
+
+static void run_search_loop(GameState *state, GameSync *sync, SearchEngineADT engine, EndgameADT solver,
+                            unsigned budget_ms, SearchStats *stats)
+{
+  unsigned me = 0;
+  bool finished_now = false;
+  if (!find_player_index_by_pid(state, sync, getpid(), &me, &finished_now))
+  {
+    fprintf(stderr, "search_player: PID %d not registered in GameState\n", (int)getpid());
+    return;
+  }
+  if (finished_now)
+    return;
+
+  unsigned max_credits = state->move_credits;
+  if (max_credits < 1)
+    max_credits = 1;
+  if (max_credits > MAX_MOVE_CREDITS)
+    max_credits = MAX_MOVE_CREDITS;
+
+  SearchPosition *pos = malloc(sizeof(SearchPosition));
+  if (pos == NULL)
+  {
+    fprintf(stderr, "search_player: out of memory\n");
+    return;
+  }
+  EndgameState endgame = {0};
+
+  // Sólo el camino exacto de un final sellado se envía con movimientos propios
+  // en vuelo, de a media ventana; las búsquedas necesitan el estado al día
+  unsigned chunk = (max_credits + 1) / 2;
+  unsigned held = 0, in_flight = 0;
+
+  while (true)
+  {
+    bool pipelined = endgame.active && endgame.plan.exact && endgame.next < (unsigned)endgame.plan.len;
+    unsigned returned;
+    if (!collect_credits(sync, me, &held, pipelined ? chunk : max_credits, &returned))
+      break;
+    in_flight -= returned < in_flight ? returned : in_flight;
+
+    // Sólo la copia se hace bajo el lock; la búsqueda no frena al master
+    game_sync_reader_enter(sync);
+    finished_now = state->finished;
+    bool have_position = !finished_now && position_snapshot(pos, state, (int)me);
+    game_sync_reader_exit(sync);
+    if (finished_now || !have_position)
+      break;
+
+    unsigned char msg[1 + MAX_MOVE_CREDITS];
+    unsigned char *steps = msg + 1;
+    unsigned len = 0;
+    unsigned plan_credits = held < chunk ? held : chunk;
+
+    TRACE_BEGIN(TRACE_PLAYER_THINK);
+    if (in_flight > 0)
+    {
+      // Fuera del camino: esperar a lo que está en vuelo y volver a decidir
+      len = take_plan_steps(&endgame, pos, in_flight, plan_credits, steps);
+      if (len == 0)
+      {
+        endgame.active = false;
+        TRACE_END(TRACE_PLAYER_THINK);
+        continue;
+      }
+      stats->endgame_moves += len;
+    }
+    else
+    {
+      // Un plan exacto sigue valiendo; uno aproximado se intenta mejorar
+      if (endgame.active && endgame.plan.exact)
+        len = take_plan_steps(&endgame, pos, 0, plan_credits, steps);
+      if (len == 0 && solve_endgame(solver, &endgame, pos, budget_ms, stats))
+        len = take_plan_steps(&endgame, pos, 0, plan_credits, steps);
+      if (len > 0)
+        stats->endgame_moves += len;
+      else
+      {
+        endgame.active = false;
+        SearchResult r = search_engine_best_move(engine, pos);
+        if (r.move >= 0)
+        {
+          steps[len++] = (unsigned char)r.move;
+          stats->moves++;
+          stats->depth_sum += r.depth;
+          stats->nodes += r.nodes;
+          stats->tt_hits += r.tt_hits;
+          stats->exact += r.exact;
+        }
+      }
+    }
+    TRACE_END(TRACE_PLAYER_THINK);
+    if (len == 0)
+    {
+      close(STDOUT_FILENO);
+      break;
+    }
+
+    held -= len;
+    in_flight += len;
+
+    // Un solo paso va con el protocolo de 1 byte, como en player.c
+    const unsigned char *out = steps;
+    size_t out_len = 1;
+    if (len > 1)
+    {
+      msg[0] = (unsigned char)(MOVE_PLAN_FLAG | len);
+      out = msg;
+      out_len = 1 + len;
+    }
+    if (write(STDOUT_FILENO, out, out_len) != (ssize_t)out_len)
+    {
+      fprintf(stderr, "search_player: failed to write direction to stdout: %s\n", strerror(errno));
+      close(STDOUT_FILENO);
+      break;
+    }
+  }
+  free(pos);
+}
+
+int main(int argc, char **argv)
+{
+  // width/height (si vienen) se ignoran: el mapeo sale de la cabecera
+  if (argc != 1 && argc != 3)
+  {
+    fprintf(stderr, "search_player: invalid usage. Usage: %s [<width> <height>]\n", argv[0]);
+    return 1;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  SearchConfig cfg;
+  search_config_from_env(&cfg);
+
+  SearchPlayerResources res = {0};
+  if (!init_resources(&res))
+    return 1;
+
+  SearchEngineADT engine = search_engine_create(&cfg);
+  if (engine == NULL)
+  {
+    fprintf(stderr, "search_player: failed to start %u search threads: %s\n", cfg.threads, strerror(errno));
+    cleanup_resources(&res);
+    return 1;
+  }
+
+  EndgameADT solver = endgame_create();
+  if (solver == NULL)
+  {
+    fprintf(stderr, "search_player: failed to create the endgame solver: %s\n", strerror(errno));
+    search_engine_destroy(engine);
+    cleanup_resources(&res);
+    return 1;
+  }
+
+  trace_attach("search_player");
+  SearchStats stats = {0};
+  run_search_loop(res.state, res.sync, engine, solver, cfg.budget_ms, &stats);
+  endgame_destroy(solver);
+  search_engine_destroy(engine);
+  if (stats.moves + stats.endgame_moves > 0)
+  {
+    fprintf(stderr,
+            "search_player %d: %llu moves, mean depth %.1f, %llu nodes (%llu from the table), %llu solved exactly "
+            "(budget %u ms, %u threads, table %u MB); %llu endgame moves, %llu regions solved exactly\n",
+            (int)getpid(), stats.moves, stats.moves ? (double)stats.depth_sum / (double)stats.moves : 0.0,
+            stats.nodes, stats.tt_hits, stats.exact, cfg.budget_ms, cfg.threads, cfg.tt_mb, stats.endgame_moves,
+            stats.endgame_solved);
+  }
+
+  cleanup_resources(&res);
+  return 0;
+}
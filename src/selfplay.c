@@ -0,0 +1,434 @@
+#define _POSIX_C_SOURCE 200809L // para getopt, clock_gettime y rand_r
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "constants.h"
+#include "game_rules.h"
+#include "game_state.h"
+
+// Simulador de partidas para ajustar jugadores: las mismas reglas que el
+// master (game_rules.h) sobre un GameState privado de cada hilo, sin vista,
+// memoria compartida, semáforos ni procesos. Cada hilo toma partidas de un
+// contador común y las juega enteras; al final se suman los agregados.
+//
+// La partida g usa la semilla seed + g, con las recompensas de
+// board_procedural_reward y los spawns del master: el mismo tablero que
+// `master -g -s <seed + g>`. Se juega por rondas, un movimiento por jugador
+// y ronda, rotando quién abre la ronda de una partida a la siguiente; un
+// jugador sin celdas libres vecinas queda bloqueado, como el que cierra su
+// pipe en el master.
+//
+// Políticas:
+//   greedy        la vecina de mayor recompensa (el paso de player.c)
+//   wall          la vecina con menos salidas libres (la de loadgen)
+//   random        una vecina libre cualquiera
+//   heur:R,E      la que maximiza R * recompensa + E * salidas libres
+
+#define DEFAULT_SIM_WIDTH 10
+#define DEFAULT_SIM_HEIGHT 10
+#define DEFAULT_SIM_GAMES 1000
+
+typedef enum
+{
+    POLICY_GREEDY,
+    POLICY_WALL,
+    POLICY_RANDOM,
+    POLICY_HEURISTIC
+} PolicyKind;
+
+typedef struct
+{
+    PolicyKind kind;
+    int reward_weight; // sólo POLICY_HEURISTIC
+    int exits_weight;
+    const char *name;
+} Policy;
+
+typedef struct
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int games;
+    unsigned int threads;
+    unsigned int seed;
+    int player_count;
+    Policy policies[MAX_PLAYERS];
+} SimArgs;
+
+typedef struct
+{
+    unsigned long long wins; // puntaje máximo de la partida, empates incluidos
+    unsigned long long score_sum;
+    unsigned long long moves;
+    unsigned int score_min;
+    unsigned int score_max;
+} SeatStats;
+
+typedef struct
+{
+    const SimArgs *args;
+    atomic_uint *next_game;
+    pthread_t thread;
+    GameState *state;
+    unsigned long long moves;
+    SeatStats seats[MAX_PLAYERS];
+} SimWorker;
+
+static void print_usage(const char *exec_name)
+{
+    fprintf(stderr,
+            "Usage: %s [-w width] [-h height] [-n games] [-t threads] [-s seed] -p policy [policy ...]\n"
+            "Policies: greedy, wall, random, heur:<reward_weight>,<exits_weight>\n",
+            exec_name);
+}
+
+static bool parse_policy(const char *text, Policy *out)
+{
+    out->name = text;
+    out->reward_weight = 0;
+    out->exits_weight = 0;
+    if (strcmp(text, "greedy") == 0)
+        out->kind = POLICY_GREEDY;
+    else if (strcmp(text, "wall") == 0)
+        out->kind = POLICY_WALL;
+    else if (strcmp(text, "random") == 0)
+        out->kind = POLICY_RANDOM;
+    else if (strncmp(text, "heur:", 5) == 0)
+    {
+        char tail;
+        out->kind = POLICY_HEURISTIC;
+        if (sscanf(text + 5, "%d,%d%c", &out->reward_weight, &out->exits_weight, &tail) != 2)
+            return false;
+    }
+    else
+        return false;
+    return true;
+}
+
+static bool parse_args(int argc, char **argv, SimArgs *args)
+{
+    *args = (SimArgs){.width = DEFAULT_SIM_WIDTH, .height = DEFAULT_SIM_HEIGHT, .games = DEFAULT_SIM_GAMES};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    args->threads = cpus > 0 ? (unsigned int)cpus : 1;
+    args->seed = (unsigned int)time(NULL);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:n:t:s:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            args->width = atoi(optarg);
+            break;
+        case 'h':
+            args->height = atoi(optarg);
+            break;
+        case 'n':
+            args->games = atoi(optarg);
+            break;
+        case 't':
+            args->threads = atoi(optarg);
+            break;
+        case 's':
+            args->seed = atoi(optarg);
+            break;
+        case 'p':
+            // Como en el master: los argumentos siguientes que no parecen
+            // opción también son jugadores
+            optind--;
+            while (optind < argc && argv[optind][0] != '-')
+            {
+                if (args->player_count == MAX_PLAYERS)
+                {
+                    fprintf(stderr, "Error: Maximum number of players is %d.\n", MAX_PLAYERS);
+                    return false;
+                }
+                if (!parse_policy(argv[optind], &args->policies[args->player_count]))
+                {
+                    fprintf(stderr, "Error: Unknown policy '%s'.\n", argv[optind]);
+                    print_usage(argv[0]);
+                    return false;
+                }
+                args->player_count++;
+                optind++;
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (args->player_count == 0)
+    {
+        fprintf(stderr, "Error: At least one policy must be specified with -p.\n");
+        print_usage(argv[0]);
+        return false;
+    }
+    if (args->width < MIN_WIDTH || args->height < MIN_HEIGHT || args->width > MAX_WIDTH ||
+        args->height > MAX_HEIGHT)
+    {
+        fprintf(stderr, "Error: Width and height must be between %d and %u.\n", MIN_WIDTH, MAX_WIDTH);
+        return false;
+    }
+    if (args->games == 0 || args->threads == 0)
+    {
+        fprintf(stderr, "Error: Games and threads must be positive.\n");
+        return false;
+    }
+    if (args->threads > args->games)
+        args->threads = args->games;
+    return true;
+}
+
+static int free_exits(const GameState *state, int x, int y)
+{
+    int exits = 0;
+    for (int d = 0; d < GAME_DIRECTIONS; d++)
+    {
+        int nx = x + GAME_DIR_DX[d];
+        int ny = y + GAME_DIR_DY[d];
+        if (board_in_bounds(state, nx, ny) && board_get(state, nx, ny) > 0)
+            exits++;
+    }
+    return exits;
+}
+
+// Devuelve la dirección elegida, o -1 si no hay celdas libres vecinas
+static int choose_move(const GameState *state, int me, const Policy *policy, unsigned int *rng)
+{
+    const Player *p = &state->players[me];
+    int best_dir = -1;
+    int best_key = 0;
+    int ties = 0;
+    for (int d = 0; d < GAME_DIRECTIONS; d++)
+    {
+        int nx = (int)p->x + GAME_DIR_DX[d];
+        int ny = (int)p->y + GAME_DIR_DY[d];
+        if (!board_in_bounds(state, nx, ny))
+            continue;
+        int reward = board_get(state, nx, ny);
+        if (reward <= 0)
+            continue;
+
+        int key = 0;
+        switch (policy->kind)
+        {
+        case POLICY_GREEDY:
+            key = reward;
+            break;
+        case POLICY_WALL:
+            key = -free_exits(state, nx, ny);
+            break;
+        case POLICY_RANDOM:
+            break;
+        case POLICY_HEURISTIC:
+            key = policy->reward_weight * reward + policy->exits_weight * free_exits(state, nx, ny);
+            break;
+        }
+
+        // greedy se queda con la primera de las mejores, como player.c; el
+        // resto desempata al azar (muestreo de reservorio)
+        if (best_dir < 0 || key > best_key)
+        {
+            best_dir = d;
+            best_key = key;
+            ties = 1;
+        }
+        else if (key == best_key && policy->kind != POLICY_GREEDY && rand_r(rng) % (unsigned int)++ties == 0)
+        {
+            best_dir = d;
+        }
+    }
+    return best_dir;
+}
+
+static void fill_board(GameState *state)
+{
+    for (unsigned int y = 0; y < state->height; y++)
+    {
+        for (unsigned int x = 0; x < state->width; x++)
+            board_set(state, x, y, board_procedural_reward(state->board_seed, x, y));
+    }
+}
+
+static void play_game(SimWorker *w, unsigned int game)
+{
+    const SimArgs *args = w->args;
+    GameState *state = w->state;
+    unsigned int seed = args->seed + game;
+    // Los desempates dependen sólo de la partida, no del hilo que la juega
+    unsigned int rng = seed * 0x9E3779B9u;
+    game_state_init_header(state, args->width, args->height, BOARD_LAYOUT_ROW_MAJOR, BOARD_MODE_EAGER, seed);
+    state->player_count = (unsigned int)args->player_count;
+    state->move_credits = 1;
+    state->finished = false;
+    fill_board(state);
+    game_rules_spawn_players(state);
+
+    int first = (int)(game % (unsigned int)args->player_count);
+    int active = args->player_count;
+    while (active > 0)
+    {
+        for (int k = 0; k < args->player_count; k++)
+        {
+            int i = (first + k) % args->player_count;
+            Player *p = &state->players[i];
+            if (p->blocked)
+                continue;
+            int dir = choose_move(state, i, &args->policies[i], &rng);
+            if (dir < 0)
+            {
+                p->blocked = true;
+                active--;
+                continue;
+            }
+            game_rules_apply_move(state, i, (unsigned char)dir);
+        }
+    }
+    state->finished = true;
+
+    unsigned int top = 0;
+    for (int i = 0; i < args->player_count; i++)
+    {
+        if (state->players[i].score > top)
+            top = state->players[i].score;
+    }
+    for (int i = 0; i < args->player_count; i++)
+    {
+        const Player *p = &state->players[i];
+        SeatStats *s = &w->seats[i];
+        s->wins += p->score == top;
+        s->score_sum += p->score;
+        s->moves += p->valid_move_requests;
+        if (p->score < s->score_min)
+            s->score_min = p->score;
+        if (p->score > s->score_max)
+            s->score_max = p->score;
+        w->moves += p->valid_move_requests;
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    SimWorker *w = arg;
+    for (;;)
+    {
+        unsigned int game = atomic_fetch_add(w->next_game, 1);
+        if (game >= w->args->games)
+            break;
+        play_game(w, game);
+    }
+    return NULL;
+}
+
+static double elapsed_seconds(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void print_report(const SimArgs *args, const SimWorker *workers, double seconds)
+{
+    SeatStats total[MAX_PLAYERS];
+    unsigned long long moves = 0;
+    for (int i = 0; i < args->player_count; i++)
+        total[i] = (SeatStats){.score_min = UINT32_MAX};
+    for (unsigned int t = 0; t < args->threads; t++)
+    {
+        moves += workers[t].moves;
+        for (int i = 0; i < args->player_count; i++)
+        {
+            const SeatStats *s = &workers[t].seats[i];
+            total[i].wins += s->wins;
+            total[i].score_sum += s->score_sum;
+            total[i].moves += s->moves;
+            if (s->score_min < total[i].score_min)
+                total[i].score_min = s->score_min;
+            if (s->score_max > total[i].score_max)
+                total[i].score_max = s->score_max;
+        }
+    }
+
+    double rate = seconds > 0 ? (double)moves / seconds : 0.0;
+    printf("%u games on %ux%u (seeds %u..%u), %llu moves in %.3f s: %.2f M moves/s, %.2f M moves/s per thread "
+           "(%u threads)\n",
+           args->games, args->width, args->height, args->seed, args->seed + args->games - 1, moves, seconds,
+           rate / 1e6, rate / 1e6 / args->threads, args->threads);
+    printf("%-4s %-24s %10s %6s %9s %7s %7s %9s\n", "seat", "policy", "wins", "win%", "mean", "min", "max", "moves");
+    double n = (double)args->games;
+    for (int i = 0; i < args->player_count; i++)
+    {
+        const SeatStats *s = &total[i];
+        printf("%-4d %-24s %10llu %5.1f%% %9.1f %7u %7u %9.1f\n", i, args->policies[i].name, s->wins,
+               100.0 * (double)s->wins / n, (double)s->score_sum / n, s->score_min, s->score_max,
+               (double)s->moves / n);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    SimArgs args;
+    if (!parse_args(argc, argv, &args))
+        return EXIT_FAILURE;
+
+    size_t state_size = GAME_STATE_MAP_SIZE(args.width, args.height, BOARD_LAYOUT_ROW_MAJOR);
+    state_size = (state_size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    SimWorker *workers = calloc(args.threads, sizeof(SimWorker));
+    if (workers == NULL)
+    {
+        fprintf(stderr, "selfplay: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    atomic_uint next_game = 0;
+    for (unsigned int t = 0; t < args.threads; t++)
+    {
+        SimWorker *w = &workers[t];
+        w->args = &args;
+        w->next_game = &next_game;
+        for (int i = 0; i < args.player_count; i++)
+            w->seats[i].score_min = UINT32_MAX;
+        w->state = aligned_alloc(CACHE_LINE_SIZE, state_size);
+        if (w->state == NULL)
+        {
+            fprintf(stderr, "selfplay: out of memory for a %ux%u board\n", args.width, args.height);
+            for (unsigned int k = 0; k < t; k++)
+                free(workers[k].state);
+            free(workers);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned int started = 1;
+    for (; started < args.threads; started++)
+    {
+        int err = pthread_create(&workers[started].thread, NULL, worker_main, &workers[started]);
+        if (err != 0)
+        {
+            fprintf(stderr, "selfplay: failed to start thread %u: %s\n", started, strerror(err));
+            break;
+        }
+    }
+    worker_main(&workers[0]);
+    for (unsigned int t = 1; t < started; t++)
+        pthread_join(workers[t].thread, NULL);
+    double seconds = elapsed_seconds(&start);
+
+    unsigned int allocated = args.threads;
+    args.threads = started;
+    print_report(&args, workers, seconds);
+
+    for (unsigned int t = 0; t < allocated; t++)
+        free(workers[t].state);
+    free(workers);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L // para getopt
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "spectator_proto.h"
+
+// Cliente mínimo del servidor de espectadores: reconstruye el tablero a partir
+// de keyframes y deltas e imprime una línea por frame (y el tablero con -b).
+
+typedef struct
+{
+    const char *socket_path;
+    bool print_board;
+} ClientArgs;
+
+typedef struct
+{
+    SpectatorFrameInfo info;
+    SpectatorPlayerRow players[SPECTATOR_MAX_PLAYER_ROWS];
+    int *board;
+    size_t cells;
+    uint32_t last_seq;
+    bool have_key;
+} ClientState;
+
+static bool read_full(int fd, void *buf, size_t len)
+{
+    unsigned char *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = read(fd, p, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+typedef struct
+{
+    const unsigned char *p;
+    const unsigned char *end;
+} Reader;
+
+static bool take(Reader *r, void *dst, size_t len)
+{
+    if ((size_t)(r->end - r->p) < len)
+        return false;
+    memcpy(dst, r->p, len);
+    r->p += len;
+    return true;
+}
+
+static bool apply_frame(ClientState *st, const SpectatorFrameHeader *h, const unsigned char *payload)
+{
+    Reader r = {.p = payload, .end = payload + h->payload_len};
+    SpectatorFrameInfo info;
+    if (!take(&r, &info, sizeof(info)) || info.player_count > SPECTATOR_MAX_PLAYER_ROWS)
+        return false;
+    if (!take(&r, st->players, info.player_count * sizeof(SpectatorPlayerRow)))
+        return false;
+
+    size_t cells = (size_t)info.width * (size_t)info.height;
+    if (cells > SPECTATOR_MAX_CELLS)
+        return false;
+    if (cells != st->cells)
+    {
+        int *board = realloc(st->board, cells * sizeof(int));
+        if (board == NULL)
+            return false;
+        st->board = board;
+        st->cells = cells;
+    }
+    st->info = info;
+
+    uint32_t run_count;
+    if (!take(&r, &run_count, sizeof(run_count)))
+        return false;
+
+    if (h->type == SPECTATOR_FRAME_KEY)
+    {
+        size_t pos = 0;
+        for (uint32_t i = 0; i < run_count; i++)
+        {
+            uint32_t count;
+            int value;
+            if (!take(&r, &count, sizeof(count)) || !take(&r, &value, sizeof(value)) || pos + count > cells)
+                return false;
+            for (uint32_t k = 0; k < count; k++)
+                st->board[pos++] = value;
+        }
+        st->have_key = pos == cells;
+        return st->have_key;
+    }
+
+    if (h->type != SPECTATOR_FRAME_DELTA || !st->have_key || h->seq != st->last_seq + 1)
+        return false;
+    for (uint32_t i = 0; i < run_count; i++)
+    {
+        uint32_t start, count;
+        if (!take(&r, &start, sizeof(start)) || !take(&r, &count, sizeof(count)) ||
+            (size_t)start + count > cells || !take(&r, &st->board[start], (size_t)count * sizeof(int)))
+            return false;
+    }
+    return true;
+}
+
+static void print_frame(const ClientState *st, const SpectatorFrameHeader *h, bool print_board)
+{
+    printf("seq=%u %s bytes=%u finished=%u", h->seq, h->type == SPECTATOR_FRAME_KEY ? "key" : "delta",
+           (unsigned)(sizeof(*h) + h->payload_len), st->info.finished);
+    for (uint32_t i = 0; i < st->info.player_count; i++)
+    {
+        const SpectatorPlayerRow *p = &st->players[i];
+        printf(" | %s %u (%u,%u)%s", p->name, p->score, p->x, p->y, p->blocked ? " blocked" : "");
+    }
+    printf("\n");
+    if (print_board)
+    {
+        for (uint32_t y = 0; y < st->info.height; y++)
+        {
+            for (uint32_t x = 0; x < st->info.width; x++)
+                printf("%3d", st->board[(size_t)y * st->info.width + x]);
+            printf("\n");
+        }
+    }
+    fflush(stdout);
+}
+
+static bool parse_args(int argc, char **argv, ClientArgs *args)
+{
+    args->socket_path = SPECTATOR_DEFAULT_SOCKET;
+    args->print_board = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:b")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            args->socket_path = optarg;
+            break;
+        case 'b':
+            args->print_board = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s socket_path] [-b]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    ClientArgs args;
+    if (!parse_args(argc, argv, &args))
+        return 1;
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(args.socket_path) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "spectator: socket path too long: %s\n", args.socket_path);
+        return 1;
+    }
+    strcpy(addr.sun_path, args.socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+    {
+        fprintf(stderr, "spectator: cannot connect to %s: %s\n", args.socket_path, strerror(errno));
+        return 1;
+    }
+
+    ClientState st = {0};
+    unsigned char *payload = NULL;
+    size_t payload_cap = 0;
+    int ret = 0;
+    SpectatorFrameHeader h;
+    while (read_full(fd, &h, sizeof(h)))
+    {
+        if (h.magic != SPECTATOR_FRAME_MAGIC)
+        {
+            fprintf(stderr, "spectator: bad frame magic %#x\n", h.magic);
+            ret = 1;
+            break;
+        }
+        if (h.payload_len > payload_cap)
+        {
+            unsigned char *p = realloc(payload, h.payload_len);
+            if (p == NULL)
+            {
+                ret = 1;
+                break;
+            }
+            payload = p;
+            payload_cap = h.payload_len;
+        }
+        if (!read_full(fd, payload, h.payload_len))
+            break;
+        if (!apply_frame(&st, &h, payload))
+        {
+            fprintf(stderr, "spectator: malformed or out-of-order frame seq=%u\n", h.seq);
+            ret = 1;
+            break;
+        }
+        st.last_seq = h.seq;
+        print_frame(&st, &h, args.print_board);
+    }
+
+    free(payload);
+    free(st.board);
+    close(fd);
+    return ret;
+}
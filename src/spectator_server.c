@@ -0,0 +1,548 @@
+#define _POSIX_C_SOURCE 200809L // para getopt y sigaction
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "game_state.h"
+#include "board.h"
+#include "game_sync.h"
+#include "shmADT.h"
+#include "spectator_proto.h"
+
+// Sidecar de espectadores: se adjunta en sólo lectura a /game_state (sin tomar
+// el RW-lock del juego: la copia se repite si se cruzó con una escritura, ver
+// game_sync_read_begin) y sirve frames a cualquier cantidad de clientes por un socket
+// Unix. Cada cliente recibe un keyframe al conectar y luego deltas; si un
+// cliente todavía no vació el frame anterior, los intermedios se descartan y
+// vuelve a sincronizarse con un keyframe. Mientras state_generation no cambie
+// (ver game_sync.h) no se copia ni se compara nada.
+
+#define SPECTATOR_MAX_CLIENTS 64
+#define DEFAULT_FRAME_INTERVAL_MS 50
+#define SNAPSHOT_TRIES 8 // copias descartadas por cruzarse con el master
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_sigint(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+typedef struct
+{
+    unsigned char *data;
+    size_t len;
+    size_t cap;
+} ByteBuf;
+
+typedef struct
+{
+    int fd;
+    ByteBuf out;
+    size_t out_off;
+    bool synced;       // recibió (encolado) el frame last_seq completo
+    uint32_t last_seq; // último frame encolado
+} SpectatorClient;
+
+typedef struct
+{
+    const char *socket_path;
+    unsigned int interval_ms;
+} ServerArgs;
+
+typedef struct
+{
+    ShmADT state_shm;
+    GameState *state;
+    ShmADT sync_shm;
+    GameSync *sync;
+    uint32_t snapshot_generation; // generación vista en el último snapshot
+    int listen_fd;
+    SpectatorClient clients[SPECTATOR_MAX_CLIENTS];
+    int client_count;
+    size_t cells;
+    int *board_prev; // snapshot privado del frame anterior
+    int *board_cur;
+    SpectatorPlayerRow players_cur[MAX_PLAYERS];
+    SpectatorPlayerRow players_prev[MAX_PLAYERS];
+    SpectatorFrameInfo info_cur;
+    SpectatorFrameInfo info_prev;
+    uint32_t seq; // seq del último frame publicado (0 = ninguno)
+    ByteBuf key_frame;
+    ByteBuf delta_frame;
+} ServerResources;
+
+static bool buf_reserve(ByteBuf *b, size_t extra)
+{
+    if (b->len + extra <= b->cap)
+        return true;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + extra)
+        cap *= 2;
+    unsigned char *data = realloc(b->data, cap);
+    if (data == NULL)
+        return false;
+    b->data = data;
+    b->cap = cap;
+    return true;
+}
+
+static bool buf_append(ByteBuf *b, const void *src, size_t len)
+{
+    if (!buf_reserve(b, len))
+        return false;
+    memcpy(b->data + b->len, src, len);
+    b->len += len;
+    return true;
+}
+
+static bool buf_append_u32(ByteBuf *b, uint32_t v)
+{
+    return buf_append(b, &v, sizeof(v));
+}
+
+// Copia el estado compartido a los buffers privados "cur"
+static void take_snapshot(ServerResources *res)
+{
+    const GameState *state = res->state;
+    res->info_cur.width = state->width;
+    res->info_cur.height = state->height;
+    res->info_cur.player_count = state->player_count > MAX_PLAYERS ? MAX_PLAYERS : state->player_count;
+    res->info_cur.finished = state->finished;
+    for (unsigned int i = 0; i < res->info_cur.player_count; i++)
+    {
+        const Player *p = &state->players[i];
+        SpectatorPlayerRow *row = &res->players_cur[i];
+        memset(row, 0, sizeof(*row));
+        memcpy(row->name, state->player_info[i].name, sizeof(row->name));
+        row->name[sizeof(row->name) - 1] = '\0';
+        row->score = p->score;
+        row->valid_move_requests = p->valid_move_requests;
+        row->invalid_move_requests = p->invalid_move_requests;
+        row->x = p->x;
+        row->y = p->y;
+        row->blocked = p->blocked;
+    }
+    // El protocolo usa orden de fila, independiente del layout del segmento
+    if (state->board_layout == BOARD_LAYOUT_ROW_MAJOR)
+    {
+        memcpy(res->board_cur, state->board, res->cells * sizeof(int));
+    }
+    else
+    {
+        size_t k = 0;
+        for (unsigned int y = 0; y < state->height; y++)
+            for (unsigned int x = 0; x < state->width; x++)
+                res->board_cur[k++] = board_get(state, x, y);
+    }
+}
+
+// Los frames se codifican a partir del snapshot "cur"; el keyframe de
+// resincronización se codifica del último publicado ("prev" tras el swap).
+typedef struct
+{
+    const SpectatorFrameInfo *info;
+    const SpectatorPlayerRow *players;
+    const int *board;
+} FrameSource;
+
+static bool begin_frame(ByteBuf *b, uint32_t type, uint32_t seq, const FrameSource *src)
+{
+    b->len = 0;
+    SpectatorFrameHeader header = {.magic = SPECTATOR_FRAME_MAGIC, .type = type, .seq = seq, .payload_len = 0};
+    return buf_append(b, &header, sizeof(header)) &&
+           buf_append(b, src->info, sizeof(*src->info)) &&
+           buf_append(b, src->players, src->info->player_count * sizeof(SpectatorPlayerRow));
+}
+
+static void end_frame(ByteBuf *b)
+{
+    SpectatorFrameHeader *header = (SpectatorFrameHeader *)b->data;
+    header->payload_len = (uint32_t)(b->len - sizeof(*header));
+}
+
+static bool encode_keyframe(ByteBuf *b, uint32_t seq, const FrameSource *src, size_t cells)
+{
+    if (!begin_frame(b, SPECTATOR_FRAME_KEY, seq, src))
+        return false;
+
+    size_t run_count_pos = b->len;
+    uint32_t run_count = 0;
+    if (!buf_append_u32(b, 0))
+        return false;
+    for (size_t i = 0; i < cells;)
+    {
+        size_t j = i + 1;
+        while (j < cells && src->board[j] == src->board[i])
+            j++;
+        if (!buf_append_u32(b, (uint32_t)(j - i)) || !buf_append(b, &src->board[i], sizeof(int)))
+            return false;
+        run_count++;
+        i = j;
+    }
+    memcpy(b->data + run_count_pos, &run_count, sizeof(run_count));
+    end_frame(b);
+    return true;
+}
+
+static bool encode_delta(ByteBuf *b, uint32_t seq, const FrameSource *src, const int *base, size_t cells)
+{
+    if (!begin_frame(b, SPECTATOR_FRAME_DELTA, seq, src))
+        return false;
+
+    size_t run_count_pos = b->len;
+    uint32_t run_count = 0;
+    if (!buf_append_u32(b, 0))
+        return false;
+    for (size_t i = 0; i < cells;)
+    {
+        if (src->board[i] == base[i])
+        {
+            i++;
+            continue;
+        }
+        size_t j = i + 1;
+        while (j < cells && src->board[j] != base[j])
+            j++;
+        if (!buf_append_u32(b, (uint32_t)i) || !buf_append_u32(b, (uint32_t)(j - i)) ||
+            !buf_append(b, &src->board[i], (j - i) * sizeof(int)))
+            return false;
+        run_count++;
+        i = j;
+    }
+    memcpy(b->data + run_count_pos, &run_count, sizeof(run_count));
+    end_frame(b);
+    return true;
+}
+
+static void drop_client(ServerResources *res, int idx)
+{
+    close(res->clients[idx].fd);
+    free(res->clients[idx].out.data);
+    res->clients[idx] = res->clients[--res->client_count];
+}
+
+// Intenta vaciar el buffer del cliente sin bloquear. Devuelve false si hay que
+// desconectarlo.
+static bool flush_client(SpectatorClient *c)
+{
+    while (c->out_off < c->out.len)
+    {
+        ssize_t n = send(c->fd, c->out.data + c->out_off, c->out.len - c->out_off, MSG_NOSIGNAL);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c->out_off += (size_t)n;
+    }
+    c->out.len = 0;
+    c->out_off = 0;
+    return true;
+}
+
+static bool enqueue_frame(SpectatorClient *c, const ByteBuf *frame, uint32_t seq)
+{
+    if (!buf_append(&c->out, frame->data, frame->len))
+        return false;
+    c->synced = true;
+    c->last_seq = seq;
+    return flush_client(c);
+}
+
+// Publica el snapshot actual si cambió y manda el delta a los clientes al día
+// con el buffer vacío. Los clientes lentos pierden este frame.
+static void publish_frame(ServerResources *res)
+{
+    // Leída antes de copiar: un cambio durante la copia se vuelve a tomar
+    uint32_t generation = game_sync_generation(res->sync);
+    if (res->seq != 0 && generation == res->snapshot_generation)
+        return;
+    res->snapshot_generation = generation;
+    // Agotados los intentos se publica igual: la escritura que se cruzó sube
+    // la generación y el próximo frame la corrige
+    for (int attempt = 0; attempt < SNAPSHOT_TRIES; attempt++)
+    {
+        uint32_t seq = game_sync_read_begin(res->sync);
+        take_snapshot(res);
+        if (!game_sync_read_retry(res->sync, seq))
+            break;
+    }
+    bool changed = res->seq == 0 ||
+                   memcmp(&res->info_cur, &res->info_prev, sizeof(res->info_cur)) != 0 ||
+                   memcmp(res->players_cur, res->players_prev, res->info_cur.player_count * sizeof(SpectatorPlayerRow)) != 0 ||
+                   memcmp(res->board_cur, res->board_prev, res->cells * sizeof(int)) != 0;
+    if (!changed)
+        return;
+
+    res->seq++;
+    FrameSource src = {.info = &res->info_cur, .players = res->players_cur, .board = res->board_cur};
+    bool have_delta = false;
+    for (int i = res->client_count - 1; i >= 0; i--)
+    {
+        SpectatorClient *c = &res->clients[i];
+        if (!c->synced || c->last_seq + 1 != res->seq)
+            continue;
+        if (c->out_off < c->out.len)
+        {
+            c->synced = false; // se resincroniza con un keyframe cuando vacíe
+            continue;
+        }
+        if (!have_delta)
+            have_delta = encode_delta(&res->delta_frame, res->seq, &src, res->board_prev, res->cells);
+        if (!have_delta || !enqueue_frame(c, &res->delta_frame, res->seq))
+            drop_client(res, i);
+    }
+
+    int *tmp = res->board_prev;
+    res->board_prev = res->board_cur;
+    res->board_cur = tmp;
+    memcpy(res->players_prev, res->players_cur, sizeof(res->players_cur));
+    res->info_prev = res->info_cur;
+}
+
+// Manda un keyframe del último frame publicado a los clientes nuevos o
+// desincronizados que ya vaciaron su buffer
+static void resync_clients(ServerResources *res)
+{
+    FrameSource src = {.info = &res->info_prev, .players = res->players_prev, .board = res->board_prev};
+    bool have_key = false;
+    for (int i = res->client_count - 1; i >= 0; i--)
+    {
+        SpectatorClient *c = &res->clients[i];
+        if ((c->synced && c->last_seq == res->seq) || c->out_off < c->out.len)
+            continue;
+        if (!have_key)
+            have_key = encode_keyframe(&res->key_frame, res->seq, &src, res->cells);
+        if (!have_key || !enqueue_frame(c, &res->key_frame, res->seq))
+            drop_client(res, i);
+    }
+}
+
+static void accept_client(ServerResources *res)
+{
+    int fd = accept(res->listen_fd, NULL, NULL);
+    if (fd == -1)
+        return;
+    if (res->client_count == SPECTATOR_MAX_CLIENTS)
+    {
+        fprintf(stderr, "spectator_server: too many clients (max %d)\n", SPECTATOR_MAX_CLIENTS);
+        close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    // Sin sincronizar: resync_clients le manda el keyframe
+    res->clients[res->client_count++] = (SpectatorClient){.fd = fd};
+}
+
+static bool parse_args(int argc, char **argv, ServerArgs *args)
+{
+    args->socket_path = SPECTATOR_DEFAULT_SOCKET;
+    args->interval_ms = DEFAULT_FRAME_INTERVAL_MS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:i:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            args->socket_path = optarg;
+            break;
+        case 'i':
+            args->interval_ms = (unsigned int)atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s socket_path] [-i frame_interval_ms]\n", argv[0]);
+            return false;
+        }
+    }
+    if (args->interval_ms == 0)
+        args->interval_ms = 1;
+    return true;
+}
+
+static bool init_resources(const ServerArgs *args, ServerResources *res)
+{
+    *res = (ServerResources){.listen_fd = -1};
+
+    res->state_shm = game_state_open("spectator_server", &res->state);
+    if (res->state_shm == NULL)
+        return false;
+
+    // Sólo lectura: el servidor sondea la generación al ritmo de sus frames
+    // en vez de dormir sobre ella, así que no se anota como espectador
+    res->sync_shm = open_shm(GAME_SYNC_SHM_NAME, sizeof(GameSync), O_RDONLY, 0600, PROT_READ);
+    if (res->sync_shm == NULL)
+    {
+        fprintf(stderr, "spectator_server: failed to open shm '%s' (read-only, size=%zu): %s\n",
+                GAME_SYNC_SHM_NAME, sizeof(GameSync), strerror(errno));
+        return false;
+    }
+    res->sync = get_shm_pointer(res->sync_shm);
+
+    res->cells = (size_t)res->state->width * (size_t)res->state->height;
+    if (res->cells > SPECTATOR_MAX_CELLS)
+    {
+        fprintf(stderr, "spectator_server: board %ux%u exceeds the %u cells a frame can carry\n",
+                res->state->width, res->state->height, SPECTATOR_MAX_CELLS);
+        return false;
+    }
+    res->board_prev = calloc(res->cells, sizeof(int));
+    res->board_cur = calloc(res->cells, sizeof(int));
+    if (res->board_prev == NULL || res->board_cur == NULL)
+    {
+        fprintf(stderr, "spectator_server: out of memory for board snapshots (cells=%zu)\n", res->cells);
+        return false;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(args->socket_path) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "spectator_server: socket path too long: %s\n", args->socket_path);
+        return false;
+    }
+    strcpy(addr.sun_path, args->socket_path);
+    // Sólo se reemplaza un socket viejo: un -s mal escrito no debe borrar un archivo
+    struct stat st;
+    if (lstat(args->socket_path, &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            fprintf(stderr, "spectator_server: %s exists and is not a socket\n", args->socket_path);
+            return false;
+        }
+        unlink(args->socket_path);
+    }
+
+    res->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (res->listen_fd == -1 ||
+        bind(res->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+        listen(res->listen_fd, SPECTATOR_MAX_CLIENTS) == -1)
+    {
+        fprintf(stderr, "spectator_server: cannot listen on %s: %s\n", args->socket_path, strerror(errno));
+        return false;
+    }
+    fcntl(res->listen_fd, F_SETFL, fcntl(res->listen_fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+static void cleanup_resources(const ServerArgs *args, ServerResources *res)
+{
+    while (res->client_count > 0)
+        drop_client(res, res->client_count - 1);
+    if (res->listen_fd != -1)
+    {
+        close(res->listen_fd);
+        unlink(args->socket_path);
+    }
+    free(res->board_prev);
+    free(res->board_cur);
+    free(res->key_frame.data);
+    free(res->delta_frame.data);
+    if (res->sync_shm)
+        close_shm(res->sync_shm);
+    if (res->state_shm)
+        close_shm(res->state_shm);
+}
+
+static void run_server_loop(const ServerArgs *args, ServerResources *res)
+{
+    struct pollfd fds[1 + SPECTATOR_MAX_CLIENTS];
+
+    publish_frame(res);
+    while (!stop_requested)
+    {
+        fds[0] = (struct pollfd){.fd = res->listen_fd, .events = POLLIN};
+        for (int i = 0; i < res->client_count; i++)
+        {
+            SpectatorClient *c = &res->clients[i];
+            fds[1 + i] = (struct pollfd){.fd = c->fd, .events = (short)(c->out_off < c->out.len ? POLLOUT : POLLIN)};
+        }
+
+        int ready = poll(fds, (nfds_t)(1 + res->client_count), (int)args->interval_ms);
+        if (ready == -1 && errno != EINTR)
+        {
+            perror("spectator_server: poll");
+            break;
+        }
+
+        if (ready > 0)
+        {
+            // Recorrer de atrás hacia adelante: drop_client mueve el último al hueco
+            for (int i = res->client_count - 1; i >= 0; i--)
+            {
+                short revents = fds[1 + i].revents;
+                if (revents & (POLLERR | POLLHUP | POLLNVAL))
+                {
+                    drop_client(res, i);
+                    continue;
+                }
+                if ((revents & POLLOUT) && !flush_client(&res->clients[i]))
+                {
+                    drop_client(res, i);
+                    continue;
+                }
+                if (revents & POLLIN)
+                {
+                    char discard[256];
+                    ssize_t n = recv(res->clients[i].fd, discard, sizeof(discard), 0);
+                    if (n == 0 || (n == -1 && errno != EAGAIN && errno != EINTR))
+                        drop_client(res, i);
+                }
+            }
+            if (fds[0].revents & POLLIN)
+                accept_client(res);
+        }
+
+        publish_frame(res);
+        resync_clients(res);
+
+        // Al terminar la partida, salir cuando todos recibieron el último frame
+        if (res->info_prev.finished)
+        {
+            bool pending = false;
+            for (int i = 0; i < res->client_count; i++)
+                pending |= res->clients[i].out_off < res->clients[i].out.len || res->clients[i].last_seq != res->seq;
+            if (!pending)
+                break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ServerArgs args;
+    if (!parse_args(argc, argv, &args))
+        return 1;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_sigint;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    ServerResources res;
+    if (!init_resources(&args, &res))
+    {
+        cleanup_resources(&args, &res);
+        return 1;
+    }
+
+    run_server_loop(&args, &res);
+
+    cleanup_resources(&args, &res);
+    return 0;
+}
@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 200809L // para getopt
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shmADT.h"
+#include "trace.h"
+
+// Convierte las rings de trazas (el volcado de master -T, o el segmento vivo
+// si no se indica archivo) al formato JSON de Chrome / Perfetto.
+
+typedef struct
+{
+    const char *input_path; // NULL = segmento vivo
+    const char *output_path; // NULL = stdout
+} ExportArgs;
+
+typedef struct
+{
+    TraceEvent event;
+    uint32_t ring;
+    uint32_t seq; // orden dentro de la ring, para desempatar (qsort no es estable)
+} MergedEvent;
+
+static void print_usage(const char *exec_name)
+{
+    fprintf(stderr, "Usage: %s [-i trace_dump] [-o trace.json]\n", exec_name);
+}
+
+static bool parse_args(int argc, char **argv, ExportArgs *args)
+{
+    *args = (ExportArgs){0};
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            args->input_path = optarg;
+            break;
+        case 'o':
+            args->output_path = optarg;
+            break;
+        default:
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mapea el volcado o el segmento. *out_len es lo que hay realmente disponible.
+static const TraceBuffer *map_input(const ExportArgs *args, size_t *out_len)
+{
+    if (args->input_path == NULL)
+    {
+        ShmADT shm = open_shm(TRACE_SHM_NAME, sizeof(TraceBuffer), O_RDONLY, 0600, PROT_READ);
+        if (shm == NULL)
+        {
+            fprintf(stderr, "trace_export: failed to open shm '%s': %s\n", TRACE_SHM_NAME, strerror(errno));
+            return NULL;
+        }
+        *out_len = sizeof(TraceBuffer);
+        return get_shm_pointer(shm);
+    }
+
+    int fd = open(args->input_path, O_RDONLY);
+    struct stat st;
+    if (fd == -1 || fstat(fd, &st) == -1)
+    {
+        fprintf(stderr, "trace_export: cannot read '%s': %s\n", args->input_path, strerror(errno));
+        if (fd != -1)
+            close(fd);
+        return NULL;
+    }
+    if ((size_t)st.st_size < offsetof(TraceBuffer, rings))
+    {
+        fprintf(stderr, "trace_export: '%s' is too short to be a trace dump\n", args->input_path);
+        close(fd);
+        return NULL;
+    }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        fprintf(stderr, "trace_export: mmap '%s' failed: %s\n", args->input_path, strerror(errno));
+        return NULL;
+    }
+    *out_len = (size_t)st.st_size;
+    return p;
+}
+
+// Copia los eventos vigentes de una ring. Con el segmento vivo el escritor
+// puede pisar el principio mientras copiamos: se descarta lo que quedó fuera
+// de la ventana según head al terminar.
+static size_t collect_ring(const TraceRing *ring, uint32_t ring_idx, MergedEvent *out)
+{
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t first = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+    static TraceEvent copy[TRACE_RING_EVENTS];
+    for (uint64_t i = first; i < head; i++)
+        copy[i - first] = ring->events[i & (TRACE_RING_EVENTS - 1)];
+    uint64_t head_after = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t valid_from = head_after > TRACE_RING_EVENTS ? head_after - TRACE_RING_EVENTS : 0;
+    if (valid_from < first)
+        valid_from = first;
+
+    // Sin el principio de la ring puede haber finales sin su comienzo
+    unsigned int depth[TRACE_EVENT_COUNT] = {0};
+    size_t n = 0;
+    for (uint64_t i = valid_from; i < head; i++)
+    {
+        const TraceEvent *e = &copy[i - first];
+        if (e->event >= TRACE_EVENT_COUNT)
+            continue;
+        if (e->phase == TRACE_PHASE_BEGIN)
+            depth[e->event]++;
+        else if (e->phase == TRACE_PHASE_END)
+        {
+            if (depth[e->event] == 0)
+                continue;
+            depth[e->event]--;
+        }
+        out[n].event = *e;
+        out[n].ring = ring_idx;
+        out[n].seq = (uint32_t)n;
+        n++;
+    }
+    return n;
+}
+
+static int compare_ts(const void *a, const void *b)
+{
+    const MergedEvent *x = a, *y = b;
+    if (x->event.ts_ns != y->event.ts_ns)
+        return x->event.ts_ns < y->event.ts_ns ? -1 : 1;
+    if (x->ring != y->ring)
+        return x->ring < y->ring ? -1 : 1;
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+static void write_json(FILE *out, const TraceBuffer *buf, uint32_t rings, const MergedEvent *events, size_t count)
+{
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        const TraceRing *ring = &buf->rings[r];
+        char name[sizeof(ring->name) + 1];
+        memcpy(name, ring->name, sizeof(ring->name));
+        name[sizeof(ring->name)] = '\0';
+        fprintf(out, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", (int)ring->pid, (int)ring->pid, name);
+        first = false;
+    }
+
+    uint64_t t0 = count > 0 ? events[0].event.ts_ns : 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const MergedEvent *m = &events[i];
+        int pid = (int)buf->rings[m->ring].pid;
+        double ts_us = (double)(m->event.ts_ns - t0) / 1000.0;
+        fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f",
+                first ? "" : ",\n", trace_event_name(m->event.event), m->event.phase, pid, pid, ts_us);
+        if (m->event.phase == TRACE_PHASE_INSTANT)
+            fprintf(out, ",\"s\":\"t\",\"args\":{\"arg\":%u}", m->event.arg);
+        fputc('}', out);
+        first = false;
+    }
+    fprintf(out, "\n]}\n");
+}
+
+int main(int argc, char **argv)
+{
+    ExportArgs args;
+    if (!parse_args(argc, argv, &args))
+        return EXIT_FAILURE;
+
+    size_t available;
+    const TraceBuffer *buf = map_input(&args, &available);
+    if (buf == NULL)
+        return EXIT_FAILURE;
+    if (buf->magic != TRACE_MAGIC || buf->version != TRACE_VERSION || buf->ring_events != TRACE_RING_EVENTS)
+    {
+        fprintf(stderr, "trace_export: incompatible trace layout (magic=%#x version=%u, expected %#x v%u)\n",
+                buf->magic, buf->version, TRACE_MAGIC, TRACE_VERSION);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t rings = atomic_load(&buf->rings_claimed);
+    if (rings > buf->ring_count)
+        rings = buf->ring_count;
+    size_t fit = (available - offsetof(TraceBuffer, rings)) / sizeof(TraceRing);
+    if (rings > fit)
+        rings = (uint32_t)fit;
+
+    MergedEvent *events = malloc((size_t)rings * TRACE_RING_EVENTS * sizeof(MergedEvent) + 1);
+    if (events == NULL)
+    {
+        fprintf(stderr, "trace_export: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    size_t count = 0;
+    for (uint32_t r = 0; r < rings; r++)
+        count += collect_ring(&buf->rings[r], r, events + count);
+    qsort(events, count, sizeof(MergedEvent), compare_ts);
+
+    FILE *out = stdout;
+    if (args.output_path && (out = fopen(args.output_path, "w")) == NULL)
+    {
+        fprintf(stderr, "trace_export: cannot write '%s': %s\n", args.output_path, strerror(errno));
+        free(events);
+        return EXIT_FAILURE;
+    }
+    write_json(out, buf, rings, events, count);
+    if (out != stdout)
+        fclose(out);
+    fprintf(stderr, "trace_export: %zu events from %u processes\n", count, rings);
+    free(events);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,330 @@
+#define _POSIX_C_SOURCE 200809L // para fsync
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "board_file.h"
+
+#define FNV_OFFSET 0xCBF29CE484222325ull
+#define FNV_PRIME 0x100000001B3ull
+#define CELL_BIAS (MAX_PLAYERS - 1) // -id más bajo posible
+
+struct BoardFileCDT
+{
+    void *map;
+    size_t map_size;
+    BoardFileHeader header;
+    const int8_t *cells;
+    int max_owner;
+};
+
+// Palabras little-endian sin depender del orden de la máquina (el compilador
+// lo reduce a una lectura o escritura simple en x86 y arm64)
+static inline uint64_t load_le64(const void *p)
+{
+    const uint8_t *b = p;
+    return (uint64_t)b[0] | (uint64_t)b[1] << 8 | (uint64_t)b[2] << 16 | (uint64_t)b[3] << 24 |
+           (uint64_t)b[4] << 32 | (uint64_t)b[5] << 40 | (uint64_t)b[6] << 48 | (uint64_t)b[7] << 56;
+}
+
+static inline uint32_t load_le32(const void *p)
+{
+    const uint8_t *b = p;
+    return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+}
+
+static inline void store_le32(void *p, uint32_t v)
+{
+    uint8_t *b = p;
+    for (int i = 0; i < 4; i++)
+        b[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void store_le64(void *p, uint64_t v)
+{
+    uint8_t *b = p;
+    for (int i = 0; i < 8; i++)
+        b[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void decode_header(const uint8_t raw[BOARD_FILE_HEADER_SIZE], BoardFileHeader *header)
+{
+    header->magic = load_le32(raw);
+    header->version = load_le32(raw + 4);
+    header->width = load_le32(raw + 8);
+    header->height = load_le32(raw + 12);
+    header->checksum = load_le64(raw + 16);
+}
+
+static void encode_header(const BoardFileHeader *header, uint8_t raw[BOARD_FILE_HEADER_SIZE])
+{
+    store_le32(raw, header->magic);
+    store_le32(raw + 4, header->version);
+    store_le32(raw + 8, header->width);
+    store_le32(raw + 12, header->height);
+    store_le64(raw + 16, header->checksum);
+}
+
+static bool write_header(FILE *f, const BoardFileHeader *header)
+{
+    uint8_t raw[BOARD_FILE_HEADER_SIZE];
+    encode_header(header, raw);
+    return fwrite(raw, sizeof(raw), 1, f) == 1;
+}
+
+// FNV-1a de a 8 celdas por paso, fila por fila: la resta de cada fila entra
+// de a una celda, así que el resultado sólo depende de width y de las celdas
+static uint64_t hash_row(uint64_t h, const int8_t *row, unsigned int width)
+{
+    unsigned int x = 0;
+    for (; x + 8 <= width; x += 8)
+        h = (h ^ load_le64(row + x)) * FNV_PRIME;
+    for (; x < width; x++)
+        h = (h ^ (uint8_t)row[x]) * FNV_PRIME;
+    return h;
+}
+
+uint64_t board_file_hash(const int8_t *cells, unsigned int width, unsigned int height)
+{
+    uint64_t h = FNV_OFFSET;
+    for (unsigned int y = 0; y < height; y++)
+        h = hash_row(h, cells + (size_t)y * width, width);
+    return h;
+}
+
+BoardFileADT board_file_open(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        fprintf(stderr, "board file: cannot open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < BOARD_FILE_HEADER_SIZE)
+    {
+        fprintf(stderr, "board file: %s is not a board file\n", path);
+        close(fd);
+        return NULL;
+    }
+    // Se recorre entero enseguida: mejor traer las páginas de una vez que de a
+    // un fallo por página
+#ifdef MAP_POPULATE
+    int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+    int flags = MAP_PRIVATE;
+#endif
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "board file: cannot map %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    BoardFileHeader header;
+    decode_header(map, &header);
+    const char *problem = NULL;
+    if (header.magic != BOARD_FILE_MAGIC)
+        problem = "bad magic";
+    else if (header.version != BOARD_FILE_VERSION)
+        problem = "unsupported version";
+    else if (header.width == 0 || header.height == 0 || header.width > MAX_WIDTH || header.height > MAX_HEIGHT)
+        problem = "bad dimensions";
+    else if ((size_t)st.st_size != BOARD_FILE_HEADER_SIZE + (size_t)header.width * header.height)
+        problem = "size does not match its dimensions";
+    if (problem)
+    {
+        fprintf(stderr, "board file: %s: %s\n", path, problem);
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    // Rango de las celdas y checksum en la misma pasada. Con el sesgo, las
+    // celdas válidas son 0..CELL_BIAS + 9 sin signo (las menores dan la vuelta
+    // hacia arriba) y el mínimo y el máximo salen con pminub/pmaxub
+    const int8_t *cells = (const int8_t *)((const uint8_t *)map + BOARD_FILE_HEADER_SIZE);
+    uint8_t lo = UINT8_MAX, hi = 0;
+    uint64_t h = FNV_OFFSET;
+    for (unsigned int y = 0; y < header.height; y++)
+    {
+        const int8_t *row = cells + (size_t)y * header.width;
+        for (unsigned int x = 0; x < header.width; x++)
+        {
+            uint8_t u = (uint8_t)(row[x] + CELL_BIAS);
+            lo = u < lo ? u : lo;
+            hi = u > hi ? u : hi;
+        }
+        h = hash_row(h, row, header.width);
+    }
+    int min_cell = (int)lo - CELL_BIAS;
+    if (hi > CELL_BIAS + 9)
+        problem = "cell out of range";
+    else if (h != header.checksum)
+        problem = "checksum mismatch";
+    struct BoardFileCDT *bf = problem ? NULL : malloc(sizeof(*bf));
+    if (bf == NULL)
+    {
+        fprintf(stderr, "board file: %s: %s\n", path, problem ? problem : strerror(errno));
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    bf->map = map;
+    bf->map_size = (size_t)st.st_size;
+    bf->header = header;
+    bf->cells = cells;
+    bf->max_owner = min_cell <= 0 ? -min_cell : -1;
+    return bf;
+}
+
+void board_file_close(BoardFileADT bf)
+{
+    if (bf == NULL)
+        return;
+    munmap(bf->map, bf->map_size);
+    free(bf);
+}
+
+unsigned int board_file_width(BoardFileADT bf)
+{
+    return bf->header.width;
+}
+
+unsigned int board_file_height(BoardFileADT bf)
+{
+    return bf->header.height;
+}
+
+uint64_t board_file_checksum(BoardFileADT bf)
+{
+    return bf->header.checksum;
+}
+
+const int8_t *board_file_cells(BoardFileADT bf)
+{
+    return bf->cells;
+}
+
+int board_file_max_owner(BoardFileADT bf)
+{
+    return bf->max_owner;
+}
+
+void board_file_load(BoardFileADT bf, GameState *state)
+{
+    unsigned int width = bf->header.width;
+    if (state->board_layout == BOARD_LAYOUT_ROW_MAJOR)
+    {
+        // Mismo orden que el archivo: una conversión int8 -> int vectorizable
+        size_t count = (size_t)width * bf->header.height;
+        for (size_t i = 0; i < count; i++)
+            state->board[i] = bf->cells[i];
+        return;
+    }
+
+    size_t storage_cells = BOARD_STORAGE_CELLS(state->width, state->height, state->board_layout);
+    for (size_t i = 0; i < storage_cells; i++)
+        state->board[i] = BOARD_CELL_VOID;
+    for (unsigned int y = 0; y < bf->header.height; y++)
+    {
+        const int8_t *row = bf->cells + (size_t)y * width;
+        for (unsigned int x = 0; x < width; x++)
+            board_set(state, x, y, row[x]);
+    }
+}
+
+static bool finish_file(FILE *f, const char *tmp_path, const char *path, bool ok)
+{
+    ok = ok && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    if (fclose(f) != 0)
+        ok = false;
+    // Como en los checkpoints: el archivo final nunca queda a medio escribir
+    if (!ok || rename(tmp_path, path) == -1)
+    {
+        fprintf(stderr, "board file: writing %s failed: %s\n", path, strerror(errno));
+        unlink(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+static FILE *open_tmp(const char *path, char **out_tmp_path)
+{
+    size_t path_len = strlen(path);
+    char *tmp_path = malloc(path_len + sizeof(".tmp"));
+    if (tmp_path == NULL)
+        return NULL;
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", sizeof(".tmp"));
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "board file: cannot open %s: %s\n", tmp_path, strerror(errno));
+        free(tmp_path);
+        return NULL;
+    }
+    *out_tmp_path = tmp_path;
+    return f;
+}
+
+bool board_file_write(const char *path, unsigned int width, unsigned int height, const int8_t *cells)
+{
+    char *tmp_path;
+    FILE *f = open_tmp(path, &tmp_path);
+    if (f == NULL)
+        return false;
+    BoardFileHeader header = {
+        .magic = BOARD_FILE_MAGIC,
+        .version = BOARD_FILE_VERSION,
+        .width = width,
+        .height = height,
+        .checksum = board_file_hash(cells, width, height),
+    };
+    size_t count = (size_t)width * height;
+    bool ok = write_header(f, &header) && fwrite(cells, 1, count, f) == count;
+    ok = finish_file(f, tmp_path, path, ok);
+    free(tmp_path);
+    return ok;
+}
+
+bool board_file_save(const char *path, const GameState *state)
+{
+    int8_t *row = malloc(state->width);
+    char *tmp_path;
+    FILE *f = row ? open_tmp(path, &tmp_path) : NULL;
+    if (f == NULL)
+    {
+        free(row);
+        return false;
+    }
+
+    // La cabecera se reescribe al final, con el checksum ya calculado
+    BoardFileHeader header = {
+        .magic = BOARD_FILE_MAGIC,
+        .version = BOARD_FILE_VERSION,
+        .width = state->width,
+        .height = state->height,
+    };
+    bool ok = write_header(f, &header);
+    uint64_t h = FNV_OFFSET;
+    for (unsigned int y = 0; ok && y < state->height; y++)
+    {
+        for (unsigned int x = 0; x < state->width; x++)
+            row[x] = (int8_t)board_get(state, x, y);
+        h = hash_row(h, row, state->width);
+        ok = fwrite(row, 1, state->width, f) == state->width;
+    }
+    header.checksum = h;
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && write_header(f, &header);
+    ok = finish_file(f, tmp_path, path, ok);
+    free(tmp_path);
+    free(row);
+    return ok;
+}
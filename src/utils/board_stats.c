@@ -0,0 +1,246 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "board_stats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BOARD_STATS_X86 1
+#include <immintrin.h>
+#else
+#define BOARD_STATS_X86 0
+#endif
+
+typedef void (*StatsKernel)(const int *cells, size_t count, BoardStats *stats);
+
+// Los kernels vectoriales acumulan en carriles de 32 bits y vuelcan a los
+// contadores de 64 bits cada STATS_BLOCK_VECTORS vectores: con recompensas
+// de 1 a 9 un carril no puede desbordar antes.
+#define STATS_BLOCK_VECTORS (1u << 20)
+
+static void stats_scalar(const int *cells, size_t count, BoardStats *stats)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int v = cells[i];
+        if (v > 0)
+        {
+            stats->free_cells++;
+            stats->reward_sum += (uint64_t)v;
+        }
+        else if (v > -MAX_PLAYERS) // descarta BOARD_CELL_VOID
+        {
+            stats->owned_cells[-v]++;
+        }
+    }
+}
+
+#if BOARD_STATS_X86
+
+__attribute__((target("sse2"))) static uint64_t hsum_epi32_sse2(__m128i v)
+{
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, v);
+    return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("sse2"))) static void stats_sse2(const int *cells, size_t count, BoardStats *stats)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    while (count - i >= 4)
+    {
+        size_t vectors = (count - i) / 4;
+        if (vectors > STATS_BLOCK_VECTORS)
+            vectors = STATS_BLOCK_VECTORS;
+
+        __m128i free_acc = zero, sum_acc = zero;
+        __m128i owned_acc[MAX_PLAYERS];
+        for (int p = 0; p < MAX_PLAYERS; p++)
+            owned_acc[p] = zero;
+
+        for (size_t k = 0; k < vectors; k++, i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(cells + i));
+            __m128i is_free = _mm_cmpgt_epi32(v, zero); // -1 en los carriles libres
+            free_acc = _mm_sub_epi32(free_acc, is_free);
+            sum_acc = _mm_add_epi32(sum_acc, _mm_and_si128(v, is_free));
+            for (int p = 0; p < MAX_PLAYERS; p++)
+                owned_acc[p] = _mm_sub_epi32(owned_acc[p], _mm_cmpeq_epi32(v, _mm_set1_epi32(-p)));
+        }
+
+        stats->free_cells += hsum_epi32_sse2(free_acc);
+        stats->reward_sum += hsum_epi32_sse2(sum_acc);
+        for (int p = 0; p < MAX_PLAYERS; p++)
+            stats->owned_cells[p] += hsum_epi32_sse2(owned_acc[p]);
+    }
+    stats_scalar(cells + i, count - i, stats);
+}
+
+__attribute__((target("avx2"))) static uint64_t hsum_epi32_avx2(__m256i v)
+{
+    uint32_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, v);
+    uint64_t total = 0;
+    for (int k = 0; k < 8; k++)
+        total += lanes[k];
+    return total;
+}
+
+__attribute__((target("avx2"))) static void stats_avx2(const int *cells, size_t count, BoardStats *stats)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    while (count - i >= 8)
+    {
+        size_t vectors = (count - i) / 8;
+        if (vectors > STATS_BLOCK_VECTORS)
+            vectors = STATS_BLOCK_VECTORS;
+
+        __m256i free_acc = zero, sum_acc = zero;
+        __m256i owned_acc[MAX_PLAYERS];
+        for (int p = 0; p < MAX_PLAYERS; p++)
+            owned_acc[p] = zero;
+
+        for (size_t k = 0; k < vectors; k++, i += 8)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(cells + i));
+            __m256i is_free = _mm256_cmpgt_epi32(v, zero);
+            free_acc = _mm256_sub_epi32(free_acc, is_free);
+            sum_acc = _mm256_add_epi32(sum_acc, _mm256_and_si256(v, is_free));
+            for (int p = 0; p < MAX_PLAYERS; p++)
+                owned_acc[p] = _mm256_sub_epi32(owned_acc[p], _mm256_cmpeq_epi32(v, _mm256_set1_epi32(-p)));
+        }
+
+        stats->free_cells += hsum_epi32_avx2(free_acc);
+        stats->reward_sum += hsum_epi32_avx2(sum_acc);
+        for (int p = 0; p < MAX_PLAYERS; p++)
+            stats->owned_cells[p] += hsum_epi32_avx2(owned_acc[p]);
+    }
+    // El resto (< 8 celdas) con el kernel de 4
+    stats_sse2(cells + i, count - i, stats);
+}
+
+#endif /* BOARD_STATS_X86 */
+
+static StatsKernel selected_kernel = stats_scalar;
+static const char *selected_name = "scalar";
+static pthread_once_t select_once = PTHREAD_ONCE_INIT;
+
+static void select_kernel(void)
+{
+    const char *limit = getenv("BOARD_STATS_KERNEL");
+    bool allow_sse2 = !(limit && strcmp(limit, "scalar") == 0);
+    bool allow_avx2 = allow_sse2 && !(limit && strcmp(limit, "sse2") == 0);
+#if BOARD_STATS_X86
+    __builtin_cpu_init();
+    if (allow_avx2 && __builtin_cpu_supports("avx2"))
+    {
+        selected_kernel = stats_avx2;
+        selected_name = "avx2";
+    }
+    else if (allow_sse2 && __builtin_cpu_supports("sse2"))
+    {
+        selected_kernel = stats_sse2;
+        selected_name = "sse2";
+    }
+#else
+    (void)allow_avx2;
+#endif
+}
+
+void board_stats_accumulate(const int *cells, size_t count, BoardStats *stats)
+{
+    pthread_once(&select_once, select_kernel);
+    selected_kernel(cells, count, stats);
+}
+
+const char *board_stats_kernel_name(void)
+{
+    pthread_once(&select_once, select_kernel);
+    return selected_name;
+}
+
+// Recorre sólo los tiles materializados: el resumen de segundo nivel indica
+// qué palabras del mapa tienen algún bit, y cada bit es un tile de 64 celdas.
+static void stats_materialised_tiles(const GameState *state, BoardStats *out)
+{
+    const uint64_t *map = board_chunk_map(state);
+    const uint64_t *summary = board_chunk_summary(state);
+    size_t summary_words = BOARD_CHUNK_SUMMARY_WORDS(state->width, state->height);
+    const size_t tile_cells = (size_t)BOARD_TILE_SIZE * BOARD_TILE_SIZE;
+
+    for (size_t s = 0; s < summary_words; s++)
+    {
+        uint64_t words = __atomic_load_n(&summary[s], __ATOMIC_ACQUIRE);
+        while (words)
+        {
+            size_t w = s * 64 + (size_t)__builtin_ctzll(words);
+            words &= words - 1;
+            uint64_t tiles = __atomic_load_n(&map[w], __ATOMIC_ACQUIRE);
+            while (tiles)
+            {
+                size_t tile = w * 64 + (size_t)__builtin_ctzll(tiles);
+                tiles &= tiles - 1;
+                board_stats_accumulate(&state->board[tile * tile_cells], tile_cells, out);
+            }
+        }
+    }
+}
+
+void board_stats_board(const GameState *state, BoardStats *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (state->board_mode == BOARD_MODE_EAGER)
+    {
+        board_stats_accumulate(state->board, BOARD_STORAGE_CELLS(state->width, state->height, state->board_layout), out);
+        return;
+    }
+
+    stats_materialised_tiles(state, out);
+    // Toda celda dentro del tablero de un tile materializado es libre o de alguien
+    uint64_t explored = out->free_cells;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        explored += out->owned_cells[p];
+    out->unexplored_cells = (uint64_t)state->width * state->height - explored;
+}
+
+void board_stats_rect(const GameState *state, unsigned int x0, unsigned int y0, unsigned int w, unsigned int h,
+                      BoardStats *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (x0 >= state->width || y0 >= state->height)
+        return;
+    unsigned int x1 = w > state->width - x0 ? state->width : x0 + w;
+    unsigned int y1 = h > state->height - y0 ? state->height : y0 + h;
+
+    for (unsigned int y = y0; y < y1; y++)
+    {
+        if (state->board_layout == BOARD_LAYOUT_ROW_MAJOR)
+        {
+            board_stats_accumulate(&state->board[board_index(state, x0, y)], x1 - x0, out);
+            continue;
+        }
+        // En tiles, una fila es contigua sólo dentro de cada tile
+        for (unsigned int x = x0; x < x1;)
+        {
+            unsigned int run = BOARD_TILE_SIZE - (x & (BOARD_TILE_SIZE - 1));
+            if (run > x1 - x)
+                run = x1 - x;
+            if (state->board_mode == BOARD_MODE_PROCEDURAL && !board_chunk_materialised(state, x, y))
+            {
+                for (unsigned int k = 0; k < run; k++)
+                {
+                    out->free_cells++;
+                    out->reward_sum += (uint64_t)board_procedural_reward(state->board_seed, x + k, y);
+                }
+            }
+            else
+            {
+                board_stats_accumulate(&state->board[board_index(state, x, y)], run, out);
+            }
+            x += run;
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#define _POSIX_C_SOURCE 200809L // para pthread_sigmask y fsync
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t state_size;
+    CheckpointMeta meta;
+} CheckpointHeader;
+
+struct CheckpointCDT
+{
+    char *path;
+    char *tmp_path;
+    size_t state_size;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool pending; // hay un buffer listo para escribir (o escribiéndose)
+    bool quit;
+    CheckpointHeader header;
+    GameState *buffer; // copia privada del estado
+};
+
+static bool write_file(struct CheckpointCDT *cp)
+{
+    FILE *f = fopen(cp->tmp_path, "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "checkpoint: cannot open %s: %s\n", cp->tmp_path, strerror(errno));
+        return false;
+    }
+
+    bool ok = fwrite(&cp->header, sizeof(cp->header), 1, f) == 1 &&
+              fwrite(cp->buffer, cp->state_size, 1, f) == 1 &&
+              fflush(f) == 0 && fsync(fileno(f)) == 0;
+    if (fclose(f) != 0)
+        ok = false;
+
+    // rename es atómico: un checkpoint en disco nunca queda a medio escribir
+    if (!ok || rename(cp->tmp_path, cp->path) == -1)
+    {
+        fprintf(stderr, "checkpoint: writing %s failed: %s\n", cp->path, strerror(errno));
+        unlink(cp->tmp_path);
+        return false;
+    }
+    return true;
+}
+
+static void *writer_thread(void *arg)
+{
+    struct CheckpointCDT *cp = arg;
+    pthread_mutex_lock(&cp->mutex);
+    while (true)
+    {
+        while (!cp->pending && !cp->quit)
+            pthread_cond_wait(&cp->cond, &cp->mutex);
+        if (!cp->pending && cp->quit)
+            break;
+
+        // El buffer no se toca mientras pending esté activo
+        pthread_mutex_unlock(&cp->mutex);
+        write_file(cp);
+        pthread_mutex_lock(&cp->mutex);
+
+        cp->pending = false;
+        pthread_cond_broadcast(&cp->cond);
+    }
+    pthread_mutex_unlock(&cp->mutex);
+    return NULL;
+}
+
+CheckpointADT checkpoint_create(const char *path, size_t state_size)
+{
+    struct CheckpointCDT *cp = calloc(1, sizeof(*cp));
+    if (cp == NULL)
+        return NULL;
+
+    size_t path_len = strlen(path);
+    cp->path = strdup(path);
+    cp->tmp_path = malloc(path_len + sizeof(".tmp"));
+    cp->buffer = malloc(state_size);
+    if (cp->path == NULL || cp->tmp_path == NULL || cp->buffer == NULL)
+    {
+        free(cp->path);
+        free(cp->tmp_path);
+        free(cp->buffer);
+        free(cp);
+        return NULL;
+    }
+    memcpy(cp->tmp_path, path, path_len);
+    memcpy(cp->tmp_path + path_len, ".tmp", sizeof(".tmp"));
+    cp->state_size = state_size;
+
+    pthread_mutex_init(&cp->mutex, NULL);
+    pthread_cond_init(&cp->cond, NULL);
+
+    // Las señales (SIGINT) deben llegarle al hilo principal del master
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int err = pthread_create(&cp->thread, NULL, writer_thread, cp);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0)
+    {
+        errno = err;
+        pthread_mutex_destroy(&cp->mutex);
+        pthread_cond_destroy(&cp->cond);
+        free(cp->path);
+        free(cp->tmp_path);
+        free(cp->buffer);
+        free(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+static void fill_buffer(struct CheckpointCDT *cp, const GameState *state, const CheckpointMeta *meta)
+{
+    cp->header = (CheckpointHeader){
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .state_size = cp->state_size,
+        .meta = *meta,
+    };
+    memcpy(cp->buffer, state, cp->state_size);
+}
+
+bool checkpoint_submit(CheckpointADT cp, const GameState *state, const CheckpointMeta *meta)
+{
+    pthread_mutex_lock(&cp->mutex);
+    bool busy = cp->pending;
+    if (!busy)
+    {
+        fill_buffer(cp, state, meta);
+        cp->pending = true;
+        pthread_cond_broadcast(&cp->cond);
+    }
+    pthread_mutex_unlock(&cp->mutex);
+    return !busy;
+}
+
+bool checkpoint_write_now(CheckpointADT cp, const GameState *state, const CheckpointMeta *meta)
+{
+    pthread_mutex_lock(&cp->mutex);
+    while (cp->pending)
+        pthread_cond_wait(&cp->cond, &cp->mutex);
+    fill_buffer(cp, state, meta);
+    bool ok = write_file(cp);
+    pthread_mutex_unlock(&cp->mutex);
+    return ok;
+}
+
+void checkpoint_destroy(CheckpointADT cp)
+{
+    if (cp == NULL)
+        return;
+    pthread_mutex_lock(&cp->mutex);
+    cp->quit = true;
+    pthread_cond_broadcast(&cp->cond);
+    pthread_mutex_unlock(&cp->mutex);
+    pthread_join(cp->thread, NULL);
+
+    pthread_mutex_destroy(&cp->mutex);
+    pthread_cond_destroy(&cp->cond);
+    free(cp->path);
+    free(cp->tmp_path);
+    free(cp->buffer);
+    free(cp);
+}
+
+bool checkpoint_load(const char *path, CheckpointMeta *out_meta, GameState **out_state, size_t *out_size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "checkpoint: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    CheckpointHeader header;
+    GameState *state = NULL;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+              header.magic == CHECKPOINT_MAGIC &&
+              header.version == CHECKPOINT_VERSION &&
+              header.state_size >= sizeof(GameState);
+    if (ok)
+    {
+        state = malloc(header.state_size);
+        ok = state != NULL && fread(state, header.state_size, 1, f) == 1;
+    }
+    fclose(f);
+
+    // El estado guardado tiene que tener el layout de este binario
+    if (ok)
+    {
+        ok = state->magic == GAME_STATE_MAGIC &&
+             state->version == GAME_STATE_VERSION &&
+             state->board_offset == offsetof(GameState, board) &&
+             state->player_count >= 1 && state->player_count <= MAX_PLAYERS &&
+             state->map_size == header.state_size &&
+             (state->board_layout == BOARD_LAYOUT_ROW_MAJOR || state->board_layout == BOARD_LAYOUT_TILED) &&
+             header.state_size == GAME_STATE_MAP_SIZE(state->width, state->height, state->board_layout);
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "checkpoint: %s is not a valid checkpoint for this build\n", path);
+        free(state);
+        return false;
+    }
+
+    *out_meta = header.meta;
+    *out_state = state;
+    *out_size = header.state_size;
+    return true;
+}
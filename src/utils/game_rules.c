@@ -0,0 +1,92 @@
+#include <math.h>
+
+#include "board.h"
+#include "game_rules.h"
+
+#define SPAWN_RADIUS_DIVISOR 3.0
+
+const int GAME_DIR_DX[GAME_DIRECTIONS] = {0, 1, 1, 1, 0, -1, -1, -1};
+const int GAME_DIR_DY[GAME_DIRECTIONS] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+static inline int clampi(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void game_rules_spawn_players(GameState *state)
+{
+    // Cálculo elíptico alrededor del centro del tablero
+    double radius_x = ((double)state->width) / SPAWN_RADIUS_DIVISOR;
+    double radius_y = ((double)state->height) / SPAWN_RADIUS_DIVISOR;
+    if (radius_x < 1.0)
+        radius_x = 1.0;
+    if (radius_y < 1.0)
+        radius_y = 1.0;
+    int center_x = (int)state->width / 2;
+    int center_y = (int)state->height / 2;
+
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        Player *p = &state->players[i];
+        p->score = 0;
+        p->valid_move_requests = 0;
+        p->invalid_move_requests = 0;
+        p->blocked = false;
+
+        double theta = (2.0 * M_PI * (double)i) / (double)state->player_count;
+        int tx = center_x + (int)lround(radius_x * cos(theta));
+        int ty = center_y + (int)lround(radius_y * sin(theta));
+        p->x = (unsigned int)clampi(tx, 0, (int)state->width - 1);
+        p->y = (unsigned int)clampi(ty, 0, (int)state->height - 1);
+        // La celda de spawn queda ocupada por el jugador (-id)
+        board_set(state, p->x, p->y, -(int)i);
+    }
+}
+
+bool game_rules_apply_move(GameState *state, int player_idx, unsigned char move)
+{
+    Player *player = &state->players[player_idx];
+
+    int nx = (int)player->x + (move < GAME_DIRECTIONS ? GAME_DIR_DX[move] : 0);
+    int ny = (int)player->y + (move < GAME_DIRECTIONS ? GAME_DIR_DY[move] : 0);
+
+    if (move < GAME_DIRECTIONS && board_in_bounds(state, nx, ny))
+    {
+        int reward = board_get(state, nx, ny);
+        if (reward > 0)
+        {
+            player->score += reward;
+            player->x = nx;
+            player->y = ny;
+            board_set(state, nx, ny, -(player_idx));
+            player->valid_move_requests++;
+            return true;
+        }
+    }
+
+    player->invalid_move_requests++;
+    return false;
+}
+
+bool game_rules_can_move(const GameState *state, int player_idx)
+{
+    const Player *p = &state->players[player_idx];
+    for (int m = 0; m < GAME_DIRECTIONS; m++)
+    {
+        int nx = (int)p->x + GAME_DIR_DX[m];
+        int ny = (int)p->y + GAME_DIR_DY[m];
+        if (board_in_bounds(state, nx, ny) && board_get(state, nx, ny) > 0)
+            return true;
+    }
+    return false;
+}
+
+bool game_rules_any_can_move(const GameState *state)
+{
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        if (!state->players[i].blocked && game_rules_can_move(state, (int)i))
+            return true;
+    }
+    return false;
+}
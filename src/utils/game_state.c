@@ -0,0 +1,66 @@
+#include "game_state.h"
+
+void game_state_init_header(GameState *state, uint32_t width, uint32_t height, BoardLayout layout,
+                            BoardMode mode, uint32_t seed)
+{
+    state->magic = GAME_STATE_MAGIC;
+    state->version = GAME_STATE_VERSION;
+    state->map_size = GAME_STATE_MAP_SIZE(width, height, layout);
+    state->board_layout = layout;
+    state->board_mode = mode;
+    state->board_seed = seed;
+    state->chunk_map_offset = GAME_STATE_CHUNK_MAP_OFFSET(width, height, layout);
+    state->players_offset = (uint32_t)offsetof(GameState, players);
+    state->player_info_offset = (uint32_t)offsetof(GameState, player_info);
+    state->board_offset = (uint32_t)offsetof(GameState, board);
+    state->width = width;
+    state->height = height;
+}
+
+static bool header_matches_build(const GameState *state)
+{
+    return state->magic == GAME_STATE_MAGIC &&
+           state->version == GAME_STATE_VERSION &&
+           state->players_offset == offsetof(GameState, players) &&
+           state->player_info_offset == offsetof(GameState, player_info) &&
+           state->board_offset == offsetof(GameState, board) &&
+           (state->board_layout == BOARD_LAYOUT_ROW_MAJOR || state->board_layout == BOARD_LAYOUT_TILED) &&
+           (state->board_mode == BOARD_MODE_EAGER ||
+            (state->board_mode == BOARD_MODE_PROCEDURAL && state->board_layout == BOARD_LAYOUT_TILED)) &&
+           state->chunk_map_offset == GAME_STATE_CHUNK_MAP_OFFSET(state->width, state->height, state->board_layout) &&
+           state->map_size >= GAME_STATE_MAP_SIZE(state->width, state->height, state->board_layout);
+}
+
+ShmADT game_state_open(const char *who, GameState **out_state)
+{
+    // Primero sólo la parte fija (incluye la cabecera) para conocer el tamaño real
+    ShmADT probe = open_shm(GAME_STATE_SHM_NAME, sizeof(GameState), O_RDONLY, 0600, PROT_READ);
+    if (probe == NULL)
+    {
+        fprintf(stderr, "%s: failed to open shm '%s' (read-only, size=%zu): %s\n",
+                who, GAME_STATE_SHM_NAME, sizeof(GameState), strerror(errno));
+        return NULL;
+    }
+
+    const GameState *header = get_shm_pointer(probe);
+    if (!header_matches_build(header))
+    {
+        fprintf(stderr, "%s: shm '%s' has an incompatible layout (magic=%#x version=%u, expected %#x v%u)\n",
+                who, GAME_STATE_SHM_NAME, header->magic, header->version, GAME_STATE_MAGIC, GAME_STATE_VERSION);
+        close_shm(probe);
+        errno = EPROTO;
+        return NULL;
+    }
+    size_t map_size = (size_t)header->map_size;
+    close_shm(probe);
+
+    ShmADT shm = open_shm(GAME_STATE_SHM_NAME, map_size, O_RDONLY, 0600, PROT_READ);
+    if (shm == NULL)
+    {
+        fprintf(stderr, "%s: failed to open shm '%s' (read-only, size=%zu): %s\n",
+                who, GAME_STATE_SHM_NAME, map_size, strerror(errno));
+        return NULL;
+    }
+    *out_state = get_shm_pointer(shm);
+    return shm;
+}
@@ -1,23 +1,111 @@
+#define _POSIX_C_SOURCE 200809L // para nanosleep
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "game_sync.h"
+#include "trace.h"
+
+#define GENERATION_POLL_NS 1000000L // sin futex: cada cuánto se vuelve a mirar
+
+// sem_wait no se reanuda tras un handler de señal: sin reintentar, un lector
+// interrumpido seguiría como si tuviera el semáforo y lo devolvería de más
+static void sem_wait_retry(sem_t *sem)
+{
+    while (sem_wait(sem) == -1 && errno == EINTR)
+        ;
+}
 
 void game_sync_reader_enter(GameSync *s)
 {
+    TRACE_BEGIN(TRACE_READER_WAIT);
     /* Pass through turnstile to avoid starving writers (master) */
-    sem_wait(&s->master_starvation_guard);
+    sem_wait_retry(&s->master_starvation_guard);
     sem_post(&s->master_starvation_guard);
     /* Reader side of RW-lock */
-    sem_wait(&s->readers_count_mutex);
+    sem_wait_retry(&s->readers_count_mutex);
     s->readers_count++;
     if (s->readers_count == 1)
-        sem_wait(&s->state_mutex);
+        sem_wait_retry(&s->state_mutex);
     sem_post(&s->readers_count_mutex);
+    TRACE_END(TRACE_READER_WAIT);
+    TRACE_BEGIN(TRACE_READER_HELD);
 }
 
 void game_sync_reader_exit(GameSync *s)
 {
-    sem_wait(&s->readers_count_mutex);
+    TRACE_END(TRACE_READER_HELD);
+    sem_wait_retry(&s->readers_count_mutex);
     s->readers_count--;
     if (s->readers_count == 0)
         sem_post(&s->state_mutex);
     sem_post(&s->readers_count_mutex);
-}
\ No newline at end of file
+}
+
+void game_sync_writer_enter(GameSync *s)
+{
+    TRACE_BEGIN(TRACE_WRITER_WAIT);
+    /* Cerrar el torniquete: los lectores nuevos esperan hasta que entremos */
+    sem_wait_retry(&s->master_starvation_guard);
+    sem_wait_retry(&s->state_mutex);
+    sem_post(&s->master_starvation_guard);
+    // Secuencia impar antes de tocar el estado (el fence ordena las escrituras)
+    atomic_fetch_add_explicit(&s->state_seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    TRACE_END(TRACE_WRITER_WAIT);
+    TRACE_BEGIN(TRACE_WRITER_HELD);
+}
+
+void game_sync_writer_exit(GameSync *s)
+{
+    TRACE_END(TRACE_WRITER_HELD);
+    atomic_fetch_add_explicit(&s->state_seq, 1, memory_order_release);
+    sem_post(&s->state_mutex);
+}
+
+// Sin FUTEX_PRIVATE_FLAG: la palabra vive en memoria compartida entre procesos
+#ifdef __linux__
+static void futex_wake_all(_Atomic uint32_t *word)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void futex_wait(_Atomic uint32_t *word, uint32_t expected, const struct timespec *timeout)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+#endif
+
+void game_sync_publish(GameSync *s)
+{
+    // Ambos lados secuencialmente consistentes: o el master ve al espectador
+    // anotado y lo despierta, o el espectador ve la generación nueva al dormir
+    atomic_fetch_add(&s->state_generation, 1);
+#ifdef __linux__
+    if (atomic_load(&s->spectator_waiters) > 0)
+        futex_wake_all(&s->state_generation);
+#endif
+}
+
+bool game_sync_wait_generation(GameSync *s, uint32_t seen, unsigned int timeout_ms)
+{
+#ifdef __linux__
+    atomic_fetch_add(&s->spectator_waiters, 1);
+    if (atomic_load(&s->state_generation) == seen)
+    {
+        struct timespec timeout = {.tv_sec = timeout_ms / 1000, .tv_nsec = (long)(timeout_ms % 1000) * 1000000L};
+        futex_wait(&s->state_generation, seen, &timeout);
+    }
+    atomic_fetch_sub(&s->spectator_waiters, 1);
+#else
+    struct timespec step = {.tv_sec = 0, .tv_nsec = GENERATION_POLL_NS};
+    for (unsigned int waited = 0; waited < timeout_ms && game_sync_generation(s) == seen; waited++)
+        nanosleep(&step, NULL);
+#endif
+    return game_sync_generation(s) != seen;
+}
@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200809L // para pthread_sigmask y pthread_barrier_t
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "move_batch.h"
+
+// Movimientos por lote a partir de los cuales conviene despertar a los hilos:
+// la ida y vuelta por las barreras cuesta unos 5 µs, y un movimiento entre 30
+// ns (tablero en caché) y 300 ns (tablero grande, o un tile nuevo en modo -g)
+#define MOVE_BATCH_PARALLEL_MIN 96
+
+// Requests que pueden alcanzar tiles en común: las aplica un único hilo
+typedef struct
+{
+    int count;
+    int items[MAX_PLAYERS]; // índices en requests, en orden
+} Region;
+
+struct MoveBatchCDT
+{
+    unsigned int workers;
+    MoveApplyFn apply;
+    pthread_t *threads; // workers - 1
+    unsigned int started;
+    pthread_mutex_t gate_mutex; // los hilos esperan aquí hasta que las barreras existen
+    pthread_cond_t gate_cond;
+    bool gate_open;
+    pthread_barrier_t batch_start;
+    pthread_barrier_t batch_done;
+    atomic_int next_region;
+    bool quit;
+    // Lote en curso: se publica antes de batch_start
+    GameState *state;
+    MoveRequest *requests;
+    int region_count;
+    Region regions[MAX_PLAYERS];
+};
+
+// Aplica las fases de una región: en cada vuelta, el siguiente movimiento de
+// cada plan vivo, en el orden de requests
+static void apply_region(struct MoveBatchCDT *b, const Region *r)
+{
+    bool pending = true;
+    while (pending)
+    {
+        pending = false;
+        for (int k = 0; k < r->count; k++)
+        {
+            MoveRequest *req = &b->requests[r->items[k]];
+            // Plan cortado por un inválido, o completo
+            if (req->applied != req->valid || req->applied >= req->len)
+                continue;
+            if (b->apply(b->state, req->player, req->plan[req->applied]))
+                req->valid++;
+            req->applied++;
+            pending = true;
+        }
+    }
+}
+
+// Toma regiones hasta agotarlas; cada una es de un solo hilo durante el lote
+static void drain_regions(struct MoveBatchCDT *b)
+{
+    int r;
+    while ((r = atomic_fetch_add(&b->next_region, 1)) < b->region_count)
+        apply_region(b, &b->regions[r]);
+}
+
+static void *worker_thread(void *arg)
+{
+    struct MoveBatchCDT *b = arg;
+    pthread_mutex_lock(&b->gate_mutex);
+    while (!b->gate_open)
+        pthread_cond_wait(&b->gate_cond, &b->gate_mutex);
+    pthread_mutex_unlock(&b->gate_mutex);
+    if (b->quit)
+        return NULL;
+    for (;;)
+    {
+        pthread_barrier_wait(&b->batch_start);
+        if (b->quit)
+            break;
+        drain_regions(b);
+        pthread_barrier_wait(&b->batch_done);
+    }
+    return NULL;
+}
+
+MoveBatchADT move_batch_create(unsigned int workers, MoveApplyFn apply)
+{
+    if (workers == 0 || apply == NULL)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct MoveBatchCDT *b = calloc(1, sizeof(*b));
+    if (b == NULL)
+        return NULL;
+    b->workers = workers;
+    b->apply = apply;
+    if (workers == 1)
+        return b;
+
+    b->threads = calloc(workers - 1, sizeof(pthread_t));
+    if (b->threads == NULL)
+    {
+        free(b);
+        return NULL;
+    }
+    pthread_mutex_init(&b->gate_mutex, NULL);
+    pthread_cond_init(&b->gate_cond, NULL);
+
+    // Los hilos no deben recibir las señales dirigidas al master
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int err = 0;
+    for (unsigned int i = 0; i + 1 < workers && err == 0; i++)
+    {
+        err = pthread_create(&b->threads[i], NULL, worker_thread, b);
+        if (err == 0)
+            b->started++;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (err == 0)
+    {
+        pthread_barrier_init(&b->batch_start, NULL, workers);
+        pthread_barrier_init(&b->batch_done, NULL, workers);
+    }
+    // Con un arranque incompleto los hilos creados salen sin tocar las barreras
+    pthread_mutex_lock(&b->gate_mutex);
+    b->quit = err != 0;
+    b->gate_open = true;
+    pthread_cond_broadcast(&b->gate_cond);
+    pthread_mutex_unlock(&b->gate_mutex);
+    if (err != 0)
+    {
+        for (unsigned int i = 0; i < b->started; i++)
+            pthread_join(b->threads[i], NULL);
+        pthread_cond_destroy(&b->gate_cond);
+        pthread_mutex_destroy(&b->gate_mutex);
+        free(b->threads);
+        free(b);
+        errno = err;
+        return NULL;
+    }
+    return b;
+}
+
+// Rango de tiles, en un eje, que el plan puede alcanzar desde pos con len
+// pasos (cada paso mueve a lo sumo una celda)
+static void tile_span(unsigned int pos, unsigned int len, unsigned int size, unsigned int *lo, unsigned int *hi)
+{
+    unsigned int first = pos > len ? pos - len : 0;
+    unsigned int last = size - 1 - pos > len ? pos + len : size - 1;
+    *lo = first >> BOARD_TILE_SHIFT;
+    *hi = last >> BOARD_TILE_SHIFT;
+}
+
+// Agrupa las requests en regiones: dos con rangos de tiles que se tocan caen
+// en la misma. Trabajar por tiles enteros evita que dos hilos materialicen el
+// mismo tile en modo -g. Devuelve la cantidad de regiones.
+static int build_regions(struct MoveBatchCDT *b, const GameState *state, const MoveRequest *requests, int count)
+{
+    unsigned int x0[MAX_PLAYERS], x1[MAX_PLAYERS], y0[MAX_PLAYERS], y1[MAX_PLAYERS];
+    int label[MAX_PLAYERS];
+    for (int i = 0; i < count; i++)
+    {
+        const Player *p = &state->players[requests[i].player];
+        tile_span(p->x, requests[i].len, state->width, &x0[i], &x1[i]);
+        tile_span(p->y, requests[i].len, state->height, &y0[i], &y1[i]);
+        label[i] = i;
+        for (int j = 0; j < i; j++)
+        {
+            if (label[j] == label[i] || x0[i] > x1[j] || x0[j] > x1[i] || y0[i] > y1[j] || y0[j] > y1[i])
+                continue;
+            // Se fusionan los dos grupos bajo la etiqueta menor
+            int from = label[i] > label[j] ? label[i] : label[j];
+            int to = label[i] > label[j] ? label[j] : label[i];
+            for (int k = 0; k <= i; k++)
+            {
+                if (label[k] == from)
+                    label[k] = to;
+            }
+        }
+    }
+
+    // Las etiquetas son el menor índice del grupo: salen en orden de requests
+    int regions = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (label[i] != i)
+            continue;
+        Region *r = &b->regions[regions++];
+        r->count = 0;
+        for (int k = i; k < count; k++)
+        {
+            if (label[k] == i)
+                r->items[r->count++] = k;
+        }
+    }
+    return regions;
+}
+
+void move_batch_run(MoveBatchADT b, GameState *state, MoveRequest *requests, int count)
+{
+    unsigned int moves = 0;
+    for (int i = 0; i < count; i++)
+    {
+        requests[i].applied = 0;
+        requests[i].valid = 0;
+        moves += requests[i].len;
+    }
+    b->state = state;
+    b->requests = requests;
+
+    if (b->workers > 1 && moves >= MOVE_BATCH_PARALLEL_MIN)
+        b->region_count = build_regions(b, state, requests, count);
+    else
+        b->region_count = 1;
+    if (b->region_count == 1)
+    {
+        // Un solo grupo, o no hay trabajo que pague el despertar: en el llamador
+        Region *all = &b->regions[0];
+        all->count = count;
+        for (int i = 0; i < count; i++)
+            all->items[i] = i;
+        apply_region(b, all);
+        return;
+    }
+
+    atomic_store(&b->next_region, 0);
+    pthread_barrier_wait(&b->batch_start);
+    drain_regions(b);
+    pthread_barrier_wait(&b->batch_done);
+}
+
+void move_batch_destroy(MoveBatchADT b)
+{
+    if (b == NULL)
+        return;
+    if (b->workers > 1)
+    {
+        b->quit = true;
+        pthread_barrier_wait(&b->batch_start);
+        for (unsigned int i = 0; i < b->started; i++)
+            pthread_join(b->threads[i], NULL);
+        pthread_barrier_destroy(&b->batch_start);
+        pthread_barrier_destroy(&b->batch_done);
+        pthread_cond_destroy(&b->gate_cond);
+        pthread_mutex_destroy(&b->gate_mutex);
+    }
+    free(b->threads);
+    free(b);
+}
@@ -0,0 +1,344 @@
+#define _POSIX_C_SOURCE 200809L // para clock_gettime
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+#include "move_sched.h"
+#include "sample_stats.h"
+
+#define DEFAULT_EDF_PERIOD_MS 10
+#define MOVE_SCHED_MAX_SAMPLES 1000000 // esperas guardadas por jugador (una muestra si hubo más)
+#define NO_ARRIVAL (-1LL)
+
+typedef struct
+{
+    long long arrival_us; // NO_ARRIVAL si no hay solicitud pendiente
+    long long last_served_us;
+    long long deficit; // drr: movimientos que todavía puede consumir en la ronda
+    unsigned long long served;
+    unsigned long long moves;
+    unsigned long long missed; // edf: atendido tras su plazo habiendo llegado antes
+    unsigned long long waits; // esperas medidas, guardadas o no
+    uint32_t *wait_us;
+    size_t samples;
+    size_t samples_cap;
+    uint32_t max_wait_us;
+} PlayerSched;
+
+struct MoveSchedCDT
+{
+    MoveSchedPolicy policy;
+    unsigned int param; // tal como vino en la configuración (0 = por defecto)
+    long long quantum;
+    long long period_us;
+    int player_count;
+    int turn;
+    bool ready[MAX_PLAYERS];
+    PlayerSched players[MAX_PLAYERS];
+    uint64_t rng; // xorshift64 del muestreo de esperas
+};
+
+static inline long long monotonic_micros(void)
+{
+    return (long long)(monotonic_ns() / 1000u);
+}
+
+bool move_sched_parse(const char *text, MoveSchedConfig *out)
+{
+    static const struct
+    {
+        const char *name;
+        MoveSchedPolicy policy;
+        bool takes_param;
+    } NAMES[] = {
+        {"rotation", MOVE_SCHED_ROTATION, false},
+        {"fifo", MOVE_SCHED_FIFO, false},
+        {"drr", MOVE_SCHED_DRR, true},
+        {"edf", MOVE_SCHED_EDF, true},
+    };
+    for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++)
+    {
+        size_t len = strlen(NAMES[i].name);
+        if (strncmp(text, NAMES[i].name, len) != 0)
+            continue;
+        out->policy = NAMES[i].policy;
+        out->param = 0;
+        if (text[len] == '\0')
+            return true;
+        if (text[len] != ':' || !NAMES[i].takes_param)
+            return false;
+        char *end;
+        unsigned long param = strtoul(text + len + 1, &end, 10);
+        if (end == text + len + 1 || *end != '\0' || param == 0 || param > UINT32_MAX)
+            return false;
+        out->param = (unsigned int)param;
+        return true;
+    }
+    return false;
+}
+
+const char *move_sched_name(MoveSchedPolicy policy)
+{
+    switch (policy)
+    {
+    case MOVE_SCHED_FIFO:
+        return "fifo";
+    case MOVE_SCHED_DRR:
+        return "drr";
+    case MOVE_SCHED_EDF:
+        return "edf";
+    default:
+        return "rotation";
+    }
+}
+
+MoveSchedADT move_sched_create(const MoveSchedConfig *cfg, int player_count, unsigned int default_quantum,
+                               int first_turn)
+{
+    if (player_count < 1 || player_count > MAX_PLAYERS)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct MoveSchedCDT *s = calloc(1, sizeof(*s));
+    if (s == NULL)
+        return NULL;
+    s->policy = cfg->policy;
+    s->param = cfg->param;
+    s->quantum = cfg->param ? cfg->param : (default_quantum ? default_quantum : 1);
+    s->period_us = (long long)(cfg->param ? cfg->param : DEFAULT_EDF_PERIOD_MS) * 1000LL;
+    s->player_count = player_count;
+    s->turn = first_turn % player_count;
+    s->rng = 0x9E3779B97F4A7C15ULL; // semilla fija: las corridas se comparan entre sí
+    long long now = monotonic_micros();
+    for (int i = 0; i < player_count; i++)
+    {
+        s->players[i].arrival_us = NO_ARRIVAL;
+        s->players[i].last_served_us = now;
+    }
+    return s;
+}
+
+void move_sched_destroy(MoveSchedADT s)
+{
+    if (s == NULL)
+        return;
+    for (int i = 0; i < s->player_count; i++)
+        free(s->players[i].wait_us);
+    free(s);
+}
+
+void move_sched_observe(MoveSchedADT s, const bool *ready)
+{
+    long long now = 0;
+    for (int i = 0; i < s->player_count; i++)
+    {
+        PlayerSched *p = &s->players[i];
+        s->ready[i] = ready[i];
+        if (ready[i] && p->arrival_us == NO_ARRIVAL)
+        {
+            if (now == 0)
+                now = monotonic_micros();
+            p->arrival_us = now;
+        }
+        // drr: sin solicitud en cola no se acumula crédito (la deuda sí queda)
+        if (!ready[i] && p->deficit > 0)
+            p->deficit = 0;
+    }
+}
+
+// Índice del listo que minimiza key, recorriendo desde el turno para desempatar
+static int pick_min(const struct MoveSchedCDT *s, const long long *key)
+{
+    int best = -1;
+    for (int k = 0; k < s->player_count; k++)
+    {
+        int i = (s->turn + k) % s->player_count;
+        if (s->ready[i] && (best < 0 || key[i] < key[best]))
+            best = i;
+    }
+    return best;
+}
+
+static int pick_drr(struct MoveSchedCDT *s)
+{
+    bool any_ready = false;
+    for (int i = 0; i < s->player_count; i++)
+        any_ready = any_ready || s->ready[i];
+    if (!any_ready)
+        return -1;
+    // Cada vuelta sin candidatos es una ronda nueva; una solicitud cuesta a lo
+    // sumo MOVE_PLAN_LEN_MASK, así que termina
+    for (;;)
+    {
+        for (int k = 0; k < s->player_count; k++)
+        {
+            int i = (s->turn + k) % s->player_count;
+            if (s->ready[i] && s->players[i].deficit > 0)
+                return i;
+        }
+        for (int i = 0; i < s->player_count; i++)
+        {
+            if (s->ready[i])
+                s->players[i].deficit += s->quantum;
+        }
+    }
+}
+
+int move_sched_pick(MoveSchedADT s)
+{
+    long long key[MAX_PLAYERS];
+    switch (s->policy)
+    {
+    case MOVE_SCHED_FIFO:
+        for (int i = 0; i < s->player_count; i++)
+            key[i] = s->players[i].arrival_us;
+        return pick_min(s, key);
+    case MOVE_SCHED_DRR:
+        return pick_drr(s);
+    case MOVE_SCHED_EDF:
+        for (int i = 0; i < s->player_count; i++)
+            key[i] = s->players[i].last_served_us + s->period_us;
+        return pick_min(s, key);
+    default:
+        for (int k = 0; k < s->player_count; k++)
+        {
+            int i = (s->turn + k) % s->player_count;
+            if (s->ready[i])
+                return i;
+        }
+        return -1;
+    }
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static void record_wait(MoveSchedADT s, PlayerSched *p, uint32_t wait_us)
+{
+    if (wait_us > p->max_wait_us)
+        p->max_wait_us = wait_us;
+    p->waits++;
+    if (p->samples == MOVE_SCHED_MAX_SAMPLES)
+    {
+        // Muestreo de reservorio: la espera número n entra con probabilidad
+        // MAX / n, así que los percentiles cubren la partida entera y no sólo
+        // el principio
+        uint64_t slot = next_random(&s->rng) % p->waits;
+        if (slot < MOVE_SCHED_MAX_SAMPLES)
+            p->wait_us[slot] = wait_us;
+        return;
+    }
+    if (p->samples == p->samples_cap)
+    {
+        size_t cap = p->samples_cap ? p->samples_cap * 2 : 1024;
+        if (cap > MOVE_SCHED_MAX_SAMPLES)
+            cap = MOVE_SCHED_MAX_SAMPLES;
+        uint32_t *samples = realloc(p->wait_us, cap * sizeof(uint32_t));
+        if (samples == NULL)
+            return;
+        p->wait_us = samples;
+        p->samples_cap = cap;
+    }
+    p->wait_us[p->samples++] = wait_us;
+}
+
+void move_sched_served(MoveSchedADT s, int player, unsigned int moves)
+{
+    PlayerSched *p = &s->players[player];
+    long long now = monotonic_micros();
+    if (p->arrival_us != NO_ARRIVAL)
+    {
+        long long wait = now - p->arrival_us;
+        record_wait(s, p, wait > UINT32_MAX ? UINT32_MAX : (uint32_t)wait);
+        long long deadline = p->last_served_us + s->period_us;
+        if (s->policy == MOVE_SCHED_EDF && now > deadline && p->arrival_us <= deadline)
+            p->missed++;
+    }
+    p->arrival_us = NO_ARRIVAL;
+    p->last_served_us = now;
+    p->served++;
+    p->moves += moves;
+    s->ready[player] = false;
+
+    // drr: el turno sólo avanza cuando el jugador agotó su crédito
+    p->deficit -= moves > 0 ? moves : 1;
+    if (s->policy != MOVE_SCHED_DRR || p->deficit <= 0)
+        s->turn = (player + 1) % s->player_count;
+}
+
+int move_sched_turn(MoveSchedADT s)
+{
+    return s->turn;
+}
+
+void move_sched_snapshot(MoveSchedADT s, MoveSchedSnapshot *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->policy = (uint32_t)s->policy;
+    out->param = s->param;
+    out->turn = (uint32_t)s->turn;
+    out->player_count = (uint32_t)s->player_count;
+    long long now = monotonic_micros();
+    for (int i = 0; i < s->player_count; i++)
+    {
+        out->deficit[i] = s->players[i].deficit;
+        out->since_served_us[i] = now - s->players[i].last_served_us;
+    }
+}
+
+void move_sched_restore(MoveSchedADT s, const MoveSchedSnapshot *snap)
+{
+    // Los relojes monótonos de dos corridas no se comparan: se guardan edades
+    long long now = monotonic_micros();
+    s->turn = (int)(snap->turn % (uint32_t)s->player_count);
+    for (int i = 0; i < s->player_count && i < (int)snap->player_count; i++)
+    {
+        s->players[i].deficit = snap->deficit[i];
+        s->players[i].last_served_us = now - snap->since_served_us[i];
+    }
+}
+
+void move_sched_print_report(MoveSchedADT s, double seconds)
+{
+    // Índice de Jain sobre la tasa de servicio: 1 es reparto parejo, 1/n es
+    // un único jugador atendido
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < s->player_count; i++)
+    {
+        double rate = seconds > 0 ? (double)s->players[i].served / seconds : 0.0;
+        sum += rate;
+        sum_sq += rate * rate;
+    }
+    double jain = sum_sq > 0 ? (sum * sum) / ((double)s->player_count * sum_sq) : 1.0;
+    printf("Scheduling stats (%s", move_sched_name(s->policy));
+    if (s->policy == MOVE_SCHED_DRR)
+        printf(":%lld", s->quantum);
+    else if (s->policy == MOVE_SCHED_EDF)
+        printf(":%lld", s->period_us / 1000LL);
+    printf("): Jain fairness %.3f over service rates\n", jain);
+
+    for (int i = 0; i < s->player_count; i++)
+    {
+        PlayerSched *p = &s->players[i];
+        sample_stats_sort(p->wait_us, p->samples);
+        uint32_t p50 = sample_stats_percentile(p->wait_us, p->samples, 0.50);
+        uint32_t p90 = sample_stats_percentile(p->wait_us, p->samples, 0.90);
+        uint32_t p99 = sample_stats_percentile(p->wait_us, p->samples, 0.99);
+        printf("  player %d: %llu served (%.1f/s), %llu moves, wait us p50=%u p90=%u p99=%u max=%u", i, p->served,
+               seconds > 0 ? (double)p->served / seconds : 0.0, p->moves, p50, p90, p99, p->max_wait_us);
+        if (s->policy == MOVE_SCHED_EDF)
+            printf(", %llu missed deadlines", p->missed);
+        printf("\n");
+    }
+}
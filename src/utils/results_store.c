@@ -0,0 +1,469 @@
+#define _POSIX_C_SOURCE 200809L // para pread/pwrite
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "results_store.h"
+
+#define RESULTS_PATH_LEN 4096
+
+static const struct
+{
+    const char *name;
+    size_t size;
+} COLUMNS[RESULTS_COL_COUNT] = {
+    [RESULTS_COL_GAME] = {"game.u64", 8},
+    [RESULTS_COL_FINISHED_AT] = {"finished_at.u64", 8},
+    [RESULTS_COL_SEED] = {"seed.u32", 4},
+    [RESULTS_COL_WIDTH] = {"width.u32", 4},
+    [RESULTS_COL_HEIGHT] = {"height.u32", 4},
+    [RESULTS_COL_DURATION_MS] = {"duration_ms.u32", 4},
+    [RESULTS_COL_PLAYERS] = {"players.u8", 1},
+    [RESULTS_COL_SLOT] = {"slot.u8", 1},
+    [RESULTS_COL_RANK] = {"rank.u8", 1},
+    [RESULTS_COL_BINARY] = {"binary.u32", 4},
+    [RESULTS_COL_SCORE] = {"score.u32", 4},
+    [RESULTS_COL_VALID] = {"valid.u32", 4},
+    [RESULTS_COL_INVALID] = {"invalid.u32", 4},
+    [RESULTS_COL_EXIT_STATUS] = {"exit_status.i32", 4},
+};
+
+const char *results_column_name(ResultsColumn column)
+{
+    return COLUMNS[column].name;
+}
+
+size_t results_column_size(ResultsColumn column)
+{
+    return COLUMNS[column].size;
+}
+
+static bool join_path(char *out, const char *dir, const char *file)
+{
+    int n = snprintf(out, RESULTS_PATH_LEN, "%s/%s", dir, file);
+    if (n < 0 || n >= RESULTS_PATH_LEN)
+    {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    return true;
+}
+
+static bool write_all(int fd, const void *buf, size_t len, off_t offset)
+{
+    const char *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = pwrite(fd, p, len, offset);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return true;
+}
+
+// Lee el archivo entero en un buffer terminado en '\0' (vacío si no existe)
+static char *read_file(const char *path, size_t *out_len)
+{
+    *out_len = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return errno == ENOENT ? calloc(1, 1) : NULL;
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        close(fd);
+        return NULL;
+    }
+    char *buf = malloc((size_t)st.st_size + 1);
+    size_t len = 0;
+    while (buf && len < (size_t)st.st_size)
+    {
+        ssize_t n = pread(fd, buf + len, (size_t)st.st_size - len, (off_t)len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        len += (size_t)n;
+    }
+    close(fd);
+    if (buf)
+    {
+        buf[len] = '\0';
+        *out_len = len;
+    }
+    return buf;
+}
+
+// Parte data en líneas (in situ). Devuelve el arreglo de punteros.
+static char **split_lines(char *data, size_t len, uint32_t *out_count)
+{
+    uint32_t count = 0;
+    for (size_t i = 0; i < len; i++)
+        if (data[i] == '\n')
+            count++;
+    char **lines = malloc(((size_t)count + 1) * sizeof(char *));
+    if (lines == NULL)
+        return NULL;
+    uint32_t k = 0;
+    char *start = data;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (data[i] == '\n')
+        {
+            data[i] = '\0';
+            lines[k++] = start;
+            start = data + i + 1;
+        }
+    }
+    // Una última línea sin '\n' es una escritura cortada: no cuenta
+    *out_count = count;
+    return lines;
+}
+
+static bool valid_meta(const ResultsMeta *meta)
+{
+    return meta->magic == RESULTS_MAGIC && meta->version == RESULTS_VERSION && meta->column_count == RESULTS_COL_COUNT;
+}
+
+// Busca los binarios de la partida en el diccionario y agrega los que falten
+static bool resolve_binaries(const char *dir, const GameResult *result, uint32_t *ids)
+{
+    char path[RESULTS_PATH_LEN];
+    if (!join_path(path, dir, RESULTS_DICT_FILE))
+        return false;
+    size_t len;
+    char *data = read_file(path, &len);
+    if (data == NULL)
+        return false;
+    // Descartar una línea final cortada antes de agregar detrás
+    size_t valid_len = len;
+    while (valid_len > 0 && data[valid_len - 1] != '\n')
+        valid_len--;
+    uint32_t count;
+    char **names = split_lines(data, valid_len, &count);
+    if (names == NULL)
+    {
+        free(data);
+        return false;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT, 0644);
+    bool ok = fd != -1 && (valid_len == len || ftruncate(fd, (off_t)valid_len) == 0);
+    off_t end = (off_t)valid_len;
+    uint32_t next_id = count; // los nuevos se numeran a continuación
+    for (uint32_t p = 0; ok && p < result->player_count; p++)
+    {
+        const char *bin = result->players[p].binary;
+        uint32_t id = 0;
+        while (id < count && strcmp(names[id], bin) != 0)
+            id++;
+        bool found = id < count;
+        // También puede estar entre los recién agregados de esta partida
+        for (uint32_t q = 0; !found && q < p; q++)
+        {
+            if (strcmp(result->players[q].binary, bin) == 0)
+            {
+                id = ids[q];
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            if (strchr(bin, '\n') != NULL)
+            {
+                fprintf(stderr, "results: binary path with a newline cannot be stored: '%s'\n", bin);
+                errno = EINVAL;
+                ok = false;
+                break;
+            }
+            size_t blen = strlen(bin);
+            ok = write_all(fd, bin, blen, end) && write_all(fd, "\n", 1, end + (off_t)blen);
+            end += (off_t)blen + 1;
+            id = next_id++;
+        }
+        ids[p] = id;
+    }
+    int saved = errno;
+    if (fd != -1)
+        close(fd);
+    free(names);
+    free(data);
+    errno = saved;
+    return ok;
+}
+
+static void fill_column(ResultsColumn c, const GameResult *r, const uint32_t *ids, uint64_t game, uint64_t now,
+                        void *out)
+{
+    for (uint32_t i = 0; i < r->player_count; i++)
+    {
+        const PlayerResult *p = &r->players[i];
+        uint64_t v = 0;
+        switch (c)
+        {
+        case RESULTS_COL_GAME:
+            v = game;
+            break;
+        case RESULTS_COL_FINISHED_AT:
+            v = now;
+            break;
+        case RESULTS_COL_SEED:
+            v = r->seed;
+            break;
+        case RESULTS_COL_WIDTH:
+            v = r->width;
+            break;
+        case RESULTS_COL_HEIGHT:
+            v = r->height;
+            break;
+        case RESULTS_COL_DURATION_MS:
+            v = r->duration_ms;
+            break;
+        case RESULTS_COL_PLAYERS:
+            v = r->player_count;
+            break;
+        case RESULTS_COL_SLOT:
+            v = i;
+            break;
+        case RESULTS_COL_RANK:
+            v = 1;
+            for (uint32_t j = 0; j < r->player_count; j++)
+                if (r->players[j].score > p->score)
+                    v++;
+            break;
+        case RESULTS_COL_BINARY:
+            v = ids[i];
+            break;
+        case RESULTS_COL_SCORE:
+            v = p->score;
+            break;
+        case RESULTS_COL_VALID:
+            v = p->valid;
+            break;
+        case RESULTS_COL_INVALID:
+            v = p->invalid;
+            break;
+        case RESULTS_COL_EXIT_STATUS:
+            v = (uint32_t)p->exit_status;
+            break;
+        default:
+            break;
+        }
+        switch (COLUMNS[c].size)
+        {
+        case 1:
+            ((uint8_t *)out)[i] = (uint8_t)v;
+            break;
+        case 4:
+            ((uint32_t *)out)[i] = (uint32_t)v;
+            break;
+        default:
+            ((uint64_t *)out)[i] = v;
+            break;
+        }
+    }
+}
+
+static bool append_locked(const char *dir, int meta_fd, const GameResult *result)
+{
+    ResultsMeta meta = {0};
+    ssize_t n = pread(meta_fd, &meta, sizeof(meta), 0);
+    if (n == 0)
+        meta = (ResultsMeta){.magic = RESULTS_MAGIC, .version = RESULTS_VERSION, .column_count = RESULTS_COL_COUNT};
+    else if (n != (ssize_t)sizeof(meta) || !valid_meta(&meta))
+    {
+        fprintf(stderr, "results: '%s' is not a results store of version %d\n", dir, RESULTS_VERSION);
+        errno = EINVAL;
+        return false;
+    }
+
+    uint32_t ids[MAX_PLAYERS];
+    if (!resolve_binaries(dir, result, ids))
+    {
+        fprintf(stderr, "results: updating the binary dictionary in '%s' failed: %s\n", dir, strerror(errno));
+        return false;
+    }
+
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t values[MAX_PLAYERS];
+    for (int c = 0; c < RESULTS_COL_COUNT; c++)
+    {
+        char path[RESULTS_PATH_LEN];
+        if (!join_path(path, dir, COLUMNS[c].name))
+            return false;
+        int fd = open(path, O_WRONLY | O_CREAT, 0644);
+        off_t offset = (off_t)(meta.rows * COLUMNS[c].size);
+        fill_column((ResultsColumn)c, result, ids, meta.games, now, values);
+        // El truncado descarta lo que haya dejado un agregado interrumpido
+        bool ok = fd != -1 && ftruncate(fd, offset) == 0 &&
+                  write_all(fd, values, result->player_count * COLUMNS[c].size, offset);
+        int saved = errno;
+        if (fd != -1)
+            close(fd);
+        if (!ok)
+        {
+            fprintf(stderr, "results: writing column '%s' failed: %s\n", path, strerror(saved));
+            errno = saved;
+            return false;
+        }
+    }
+
+    // Confirmar: sólo ahora las filas son visibles para los lectores
+    meta.rows += result->player_count;
+    meta.games++;
+    if (!write_all(meta_fd, &meta, sizeof(meta), 0))
+    {
+        fprintf(stderr, "results: updating '%s/%s' failed: %s\n", dir, RESULTS_META_FILE, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool results_append(const char *dir, const GameResult *result)
+{
+    if (result->player_count == 0 || result->player_count > MAX_PLAYERS)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    if (mkdir(dir, 0755) == -1 && errno != EEXIST)
+    {
+        fprintf(stderr, "results: cannot create '%s': %s\n", dir, strerror(errno));
+        return false;
+    }
+    char path[RESULTS_PATH_LEN];
+    if (!join_path(path, dir, RESULTS_META_FILE))
+        return false;
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd == -1)
+    {
+        fprintf(stderr, "results: cannot open '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+    while (flock(fd, LOCK_EX) == -1)
+    {
+        if (errno != EINTR)
+        {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return false;
+        }
+    }
+    bool ok = append_locked(dir, fd, result);
+    int saved = errno;
+    close(fd); // libera el flock
+    errno = saved;
+    return ok;
+}
+
+bool results_open(const char *dir, ResultsTable *table)
+{
+    *table = (ResultsTable){0};
+    char path[RESULTS_PATH_LEN];
+    if (!join_path(path, dir, RESULTS_META_FILE))
+        return false;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        fprintf(stderr, "results: cannot open '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+    // Con el lock compartido meta y diccionario son de la misma confirmación
+    while (flock(fd, LOCK_SH) == -1 && errno == EINTR)
+        ;
+    ResultsMeta meta;
+    bool ok = pread(fd, &meta, sizeof(meta), 0) == (ssize_t)sizeof(meta) && valid_meta(&meta);
+    if (!ok)
+    {
+        fprintf(stderr, "results: '%s' is not a results store of version %d\n", dir, RESULTS_VERSION);
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    table->rows = meta.rows;
+    table->games = meta.games;
+
+    size_t dict_len = 0;
+    if (join_path(path, dir, RESULTS_DICT_FILE))
+        table->dict_data = read_file(path, &dict_len);
+    if (table->dict_data)
+    {
+        while (dict_len > 0 && table->dict_data[dict_len - 1] != '\n')
+            dict_len--;
+        table->binaries = split_lines(table->dict_data, dict_len, &table->binary_count);
+    }
+
+    for (int c = 0; ok && c < RESULTS_COL_COUNT; c++)
+    {
+        size_t bytes = (size_t)table->rows * COLUMNS[c].size;
+        if (bytes == 0)
+            continue;
+        ok = join_path(path, dir, COLUMNS[c].name);
+        int cfd = ok ? open(path, O_RDONLY) : -1;
+        struct stat st;
+        if (cfd == -1 || fstat(cfd, &st) == -1 || (size_t)st.st_size < bytes)
+        {
+            fprintf(stderr, "results: column '%s' is missing or shorter than %llu rows\n", path,
+                    (unsigned long long)table->rows);
+            ok = false;
+        }
+        else
+        {
+            void *p = mmap(NULL, bytes, PROT_READ, MAP_SHARED, cfd, 0);
+            if (p == MAP_FAILED)
+            {
+                fprintf(stderr, "results: mmap '%s' failed: %s\n", path, strerror(errno));
+                ok = false;
+            }
+            else
+            {
+                // Se recorre de principio a fin
+                madvise(p, bytes, MADV_SEQUENTIAL);
+                table->columns[c] = p;
+                table->mapped[c] = bytes;
+            }
+        }
+        if (cfd != -1)
+            close(cfd);
+    }
+    close(fd);
+
+    if (ok && table->binaries == NULL)
+    {
+        fprintf(stderr, "results: cannot read the binary dictionary of '%s'\n", dir);
+        ok = false;
+    }
+    if (!ok)
+    {
+        results_close(table);
+        errno = EINVAL;
+    }
+    return ok;
+}
+
+void results_close(ResultsTable *table)
+{
+    for (int c = 0; c < RESULTS_COL_COUNT; c++)
+    {
+        if (table->columns[c])
+            munmap((void *)table->columns[c], table->mapped[c]);
+    }
+    free(table->binaries);
+    free(table->dict_data);
+    *table = (ResultsTable){0};
+}
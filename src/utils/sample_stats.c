@@ -0,0 +1,23 @@
+#include <stdlib.h>
+
+#include "sample_stats.h"
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void sample_stats_sort(uint32_t *samples, size_t n)
+{
+    if (n > 1)
+        qsort(samples, n, sizeof(uint32_t), cmp_u32);
+}
+
+uint32_t sample_stats_percentile(const uint32_t *sorted, size_t n, double q)
+{
+    if (n == 0)
+        return 0;
+    return sorted[(size_t)(q * (double)(n - 1))];
+}
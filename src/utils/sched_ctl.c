@@ -0,0 +1,157 @@
+#define _GNU_SOURCE // sched_setaffinity, sched_getcpu
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "sched_ctl.h"
+
+bool sched_ctl_parse_cpus(const char *spec, CpuPinning *out)
+{
+    *out = (CpuPinning){0};
+    if (spec == NULL || *spec == '\0')
+        return false;
+
+    out->enabled = true;
+    if (strcmp(spec, "auto") == 0)
+    {
+        out->automatic = true;
+        return true;
+    }
+
+    const char *p = spec;
+    while (*p)
+    {
+        char *end;
+        long cpu = strtol(p, &end, 10);
+        if (end == p || cpu < 0 || cpu >= CPU_SETSIZE || out->cpu_count == SCHED_CTL_MAX_CPUS)
+            return false;
+        out->cpus[out->cpu_count++] = (int)cpu;
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return false;
+        p = end;
+    }
+    return out->cpu_count > 0;
+}
+
+bool sched_ctl_parse_policy(const char *spec, SchedSettings *out)
+{
+    *out = (SchedSettings){0};
+    if (spec == NULL)
+        return false;
+
+    const char *colon = strchr(spec, ':');
+    if (colon == NULL || colon[1] == '\0')
+        return false;
+
+    char *end;
+    long value = strtol(colon + 1, &end, 10);
+    if (*end != '\0')
+        return false;
+
+    size_t name_len = (size_t)(colon - spec);
+    if (name_len == 4 && strncmp(spec, "fifo", 4) == 0)
+    {
+        if (value < sched_get_priority_min(SCHED_FIFO) || value > sched_get_priority_max(SCHED_FIFO))
+            return false;
+        out->policy = SCHED_CTL_FIFO;
+    }
+    else if (name_len == 4 && strncmp(spec, "nice", 4) == 0)
+    {
+        if (value < -20 || value > 19)
+            return false;
+        out->policy = SCHED_CTL_NICE;
+    }
+    else
+    {
+        return false;
+    }
+    out->value = (int)value;
+    return true;
+}
+
+int sched_ctl_cpu_for_slot(const CpuPinning *pinning, int slot)
+{
+    if (pinning == NULL || !pinning->enabled)
+        return -1;
+    if (pinning->automatic)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (online < 1)
+            return -1;
+        return slot % (int)online;
+    }
+    return pinning->cpus[slot % pinning->cpu_count];
+}
+
+void sched_ctl_apply_self(const char *who, int cpu, const SchedSettings *settings)
+{
+#ifdef __linux__
+    if (cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == -1)
+            fprintf(stderr, "%s: sched_setaffinity(cpu=%d) failed: %s\n", who, cpu, strerror(errno));
+    }
+#else
+    (void)cpu;
+#endif
+
+    if (settings == NULL)
+        return;
+
+    if (settings->policy == SCHED_CTL_FIFO)
+    {
+        struct sched_param param = {.sched_priority = settings->value};
+        if (sched_setscheduler(0, SCHED_FIFO, &param) == -1)
+            fprintf(stderr, "%s: sched_setscheduler(SCHED_FIFO, %d) failed: %s\n", who, settings->value, strerror(errno));
+    }
+    else if (settings->policy == SCHED_CTL_NICE)
+    {
+        if (setpriority(PRIO_PROCESS, 0, settings->value) == -1)
+            fprintf(stderr, "%s: setpriority(%d) failed: %s\n", who, settings->value, strerror(errno));
+    }
+}
+
+int sched_ctl_last_cpu(pid_t pid)
+{
+#ifdef __linux__
+    if (pid == 0)
+        return sched_getcpu();
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return -1;
+
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+
+    // El nombre del ejecutable (campo 2) puede tener espacios: contar desde el último ')'
+    char *p = strrchr(buf, ')');
+    if (p == NULL)
+        return -1;
+    p++;
+    // "processor" es el campo 39; tras ')' comienza el campo 3
+    for (int field = 3; field < 39 && p; field++)
+    {
+        p = strchr(p + 1, ' ');
+    }
+    if (p == NULL)
+        return -1;
+    return atoi(p + 1);
+#else
+    (void)pid;
+    return -1;
+#endif
+}
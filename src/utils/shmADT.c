@@ -11,6 +11,10 @@
 
 #include "shmADT.h"
 
+// Los segmentos pueden declararse mucho más grandes de lo que se usa (tableros
+// procedurales): sin reservar swap, las páginas se asignan al tocarlas.
+#define SHM_MAP_FLAGS (MAP_SHARED | MAP_NORESERVE)
+
 struct ShmCDT
 {
         char *name;
@@ -45,7 +49,7 @@ ShmADT create_shm(const char *restrict name, size_t size, int open_flag, int mod
                 }
         }
 
-        new_shm->shmaddr = mmap(NULL, size, prot, MAP_SHARED, new_shm->fd, 0);
+        new_shm->shmaddr = mmap(NULL, size, prot, SHM_MAP_FLAGS, new_shm->fd, 0);
         if (new_shm->shmaddr == MAP_FAILED)
         {
                 close(new_shm->fd);
@@ -113,7 +117,7 @@ ShmADT open_shm(const char *restrict name, size_t size, int open_flag, int mode,
                 return NULL;
         }
 
-        opened_shm->shmaddr = mmap(NULL, size, prot, MAP_SHARED, opened_shm->fd, 0);
+        opened_shm->shmaddr = mmap(NULL, size, prot, SHM_MAP_FLAGS, opened_shm->fd, 0);
         if (opened_shm->shmaddr == MAP_FAILED)
         {
                 close(opened_shm->fd);
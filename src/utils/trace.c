@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "shmADT.h"
+#include "trace.h"
+
+TraceRing *trace_ring = NULL;
+
+static ShmADT trace_shm = NULL;
+
+static const char *const EVENT_NAMES[TRACE_EVENT_COUNT] = {
+    [TRACE_PIPE_READ] = "pipe_read",
+    [TRACE_MOVE_APPLY] = "move_apply",
+    [TRACE_VIEW_WAIT] = "view_wait",
+    [TRACE_WRITER_WAIT] = "writer_wait",
+    [TRACE_WRITER_HELD] = "writer_held",
+    [TRACE_READER_WAIT] = "reader_wait",
+    [TRACE_READER_HELD] = "reader_held",
+    [TRACE_VIEW_RENDER] = "view_render",
+    [TRACE_PLAYER_THINK] = "player_think",
+    [TRACE_CREDIT_WAIT] = "credit_wait",
+};
+
+const char *trace_event_name(unsigned int event)
+{
+    return event < TRACE_EVENT_COUNT ? EVENT_NAMES[event] : "unknown";
+}
+
+static void claim_ring(TraceBuffer *buf, const char *name)
+{
+    uint32_t idx = atomic_fetch_add(&buf->rings_claimed, 1);
+    if (idx >= buf->ring_count)
+        return; // sin rings libres: este proceso no traza
+    TraceRing *ring = &buf->rings[idx];
+    ring->pid = getpid();
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    trace_ring = ring;
+}
+
+bool trace_create(const char *name)
+{
+    trace_shm = create_shm(TRACE_SHM_NAME, sizeof(TraceBuffer), O_RDWR | O_CREAT | O_EXCL, 0666,
+                           PROT_READ | PROT_WRITE);
+    if (trace_shm == NULL)
+        return false;
+    TraceBuffer *buf = get_shm_pointer(trace_shm);
+    buf->magic = TRACE_MAGIC;
+    buf->version = TRACE_VERSION;
+    buf->ring_count = TRACE_MAX_RINGS;
+    buf->ring_events = TRACE_RING_EVENTS;
+    atomic_store(&buf->rings_claimed, 0);
+    claim_ring(buf, name);
+    return true;
+}
+
+void trace_unlink_stale(void)
+{
+    shm_unlink(TRACE_SHM_NAME);
+}
+
+void trace_attach(const char *name)
+{
+    ShmADT shm = open_shm(TRACE_SHM_NAME, sizeof(TraceBuffer), O_RDWR, 0600, PROT_READ | PROT_WRITE);
+    if (shm == NULL)
+        return; // el master no pidió trazas
+    TraceBuffer *buf = get_shm_pointer(shm);
+    if (buf->magic != TRACE_MAGIC || buf->version != TRACE_VERSION || buf->ring_events != TRACE_RING_EVENTS)
+    {
+        fprintf(stderr, "%s: ignoring trace segment '%s' with an incompatible layout\n", name, TRACE_SHM_NAME);
+        close_shm(shm);
+        return;
+    }
+    // El mapeo vive hasta que el proceso termina
+    trace_shm = shm;
+    claim_ring(buf, name);
+}
+
+bool trace_dump(const char *path)
+{
+    if (trace_shm == NULL)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        return false;
+    // Sólo hasta la última ring reclamada: el resto no se tocó nunca
+    const TraceBuffer *buf = get_shm_pointer(trace_shm);
+    uint32_t used = atomic_load(&buf->rings_claimed);
+    if (used > buf->ring_count)
+        used = buf->ring_count;
+    size_t len = offsetof(TraceBuffer, rings) + (size_t)used * sizeof(TraceRing);
+    const char *p = (const char *)buf;
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return close(fd) == 0;
+}
+
+void trace_destroy(void)
+{
+    trace_ring = NULL;
+    if (trace_shm)
+    {
+        destroy_shm(trace_shm);
+        trace_shm = NULL;
+    }
+}
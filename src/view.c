@@ -12,8 +12,11 @@
 
 #include "constants.h"
 #include "game_state.h"
+#include "board.h"
+#include "board_stats.h"
 #include "game_sync.h"
 #include "shmADT.h"
+#include "trace.h"
 
 static volatile sig_atomic_t stop_requested = 0;
 static int colors_ok = 0;
@@ -60,27 +63,96 @@ static void draw_box(int y, int x, int height, int width, const char *title)
     }
 }
 
-static void print_board(const GameState *state, const int *owner_map, const int *head_map)
+#define CELL_W 5
+#define SUMMARY_LINES 3
+
+// Ventana del tablero que entra en la terminal. En tableros más grandes que
+// la pantalla se centra en el primer jugador activo.
+typedef struct
 {
-    int start_y = 1;
-    int cell_w = 5;
-    int inner_h = (int)state->height;
-    int inner_w = (int)state->width * cell_w;
-    char title[64];
-    snprintf(title, sizeof(title), "Board %ux%u", state->width, state->height);
-    draw_box(start_y, 0, inner_h + 2, inner_w + 2, title);
+    unsigned int x0, y0;
+    unsigned int cols, rows;
+} Viewport;
+
+static unsigned int clamp_origin(unsigned int center, unsigned int visible, unsigned int total)
+{
+    if (visible >= total || center < visible / 2)
+        return 0;
+    unsigned int origin = center - visible / 2;
+    return origin + visible > total ? total - visible : origin;
+}
 
-    for (unsigned int row = 0; row < state->height; ++row)
+static Viewport compute_viewport(const GameState *state)
+{
+    // Filas reservadas: título, bordes del tablero, cajas de jugadores y resumen, estado
+    int free_rows = LINES - 1 - 2 - ((int)state->player_count + 2) - (SUMMARY_LINES + 2) - 1;
+    int free_cols = (COLS - 2) / CELL_W;
+    Viewport vp;
+    vp.rows = free_rows < 1 ? 1 : ((unsigned int)free_rows < state->height ? (unsigned int)free_rows : state->height);
+    vp.cols = free_cols < 1 ? 1 : ((unsigned int)free_cols < state->width ? (unsigned int)free_cols : state->width);
+
+    unsigned int focus = 0;
+    for (unsigned int i = 0; i < state->player_count && i < MAX_PLAYERS; ++i)
     {
-        for (unsigned int col = 0; col < state->width; ++col)
+        if (!state->players[i].blocked)
         {
-            int idx = (int)(row * state->width + col);
-            int cell = state->board[idx];
-            int owner = owner_map ? owner_map[idx] : -1;
-            int head_owner = head_map ? head_map[idx] : -1;
+            focus = i;
+            break;
+        }
+    }
+    vp.x0 = clamp_origin(state->players[focus].x, vp.cols, state->width);
+    vp.y0 = clamp_origin(state->players[focus].y, vp.rows, state->height);
+    return vp;
+}
+
+static int head_owner_at(const GameState *state, unsigned int x, unsigned int y)
+{
+    for (unsigned int i = 0; i < state->player_count && i < MAX_PLAYERS; ++i)
+    {
+        if (state->players[i].x == x && state->players[i].y == y)
+            return (int)i;
+    }
+    return -1;
+}
+
+// Lo que se dibuja en un frame. Se llena con el lock de lector tomado y se
+// dibuja después, así el master no espera a la E/S de la terminal.
+typedef struct
+{
+    GameState *snap;   // copia privada: cabecera y jugadores (en modo eager, también el tablero)
+    size_t snap_bytes;
+    Viewport vp;
+    int *cells;        // ventana visible, vp.rows x vp.cols en orden de fila
+    size_t cells_cap;
+    BoardStats board;
+    BoardStats visible;
+} ViewFrame;
+
+static void print_board(const ViewFrame *frame)
+{
+    const GameState *state = frame->snap;
+    const Viewport *vp = &frame->vp;
+    int start_y = 1;
+    char title[96];
+    if (vp->cols < state->width || vp->rows < state->height)
+        snprintf(title, sizeof(title), "Board %ux%u @ %u,%u", state->width, state->height, vp->x0, vp->y0);
+    else
+        snprintf(title, sizeof(title), "Board %ux%u", state->width, state->height);
+    draw_box(start_y, 0, (int)vp->rows + 2, (int)vp->cols * CELL_W + 2, title);
+
+    for (unsigned int row = 0; row < vp->rows; ++row)
+    {
+        for (unsigned int col = 0; col < vp->cols; ++col)
+        {
+            unsigned int bx = vp->x0 + col;
+            unsigned int by = vp->y0 + row;
+            int cell = frame->cells[(size_t)row * vp->cols + col];
+            // Las celdas ocupadas valen -id del dueño (0 es del jugador 0)
+            int owner = cell <= 0 ? -cell : -1;
+            int head_owner = head_owner_at(state, bx, by);
             short pair = owner >= 0 ? player_color_pair((unsigned int)owner) : 0;
             int y = start_y + 1 + (int)row;
-            int x = 1 + (int)col * cell_w;
+            int x = 1 + (int)col * CELL_W;
 
             if (head_owner >= 0)
             {
@@ -103,9 +175,8 @@ static void print_board(const GameState *state, const int *owner_map, const int
     }
 }
 
-static void print_players(const GameState *state)
+static void print_players(const GameState *state, int start_y)
 {
-    int start_y = (int)state->height + 3;
     int list_rows = (int)state->player_count;
     int box_w = COLS - 2;
     if (box_w < 10)
@@ -123,7 +194,7 @@ static void print_players(const GameState *state)
         mvprintw(start_y + 1 + (int)i, 1,
                  "Player %u - %s | Points %u | Pos %u,%u | Moves: %u ok, %u invalid | %s",
                  i,
-                 p->name,
+                 state->player_info[i].name,
                  p->score,
                  (unsigned)p->x,
                  (unsigned)p->y,
@@ -135,10 +206,49 @@ static void print_players(const GameState *state)
     }
 }
 
+static void print_summary(const ViewFrame *frame, int start_y)
+{
+    const GameState *state = frame->snap;
+    const BoardStats *board = &frame->board;
+    int box_w = COLS - 2;
+    if (box_w < 10)
+        box_w = 10;
+    char title[64];
+    snprintf(title, sizeof(title), "Summary (%s)", board_stats_kernel_name());
+    draw_box(start_y, 0, SUMMARY_LINES + 2, box_w, title);
+
+    if (state->board_mode == BOARD_MODE_PROCEDURAL)
+        mvprintw(start_y + 1, 1, "Board: %llu free | %llu reward left | %llu unexplored",
+                 (unsigned long long)board->free_cells, (unsigned long long)board->reward_sum,
+                 (unsigned long long)board->unexplored_cells);
+    else
+        mvprintw(start_y + 1, 1, "Board: %llu free | %llu reward left",
+                 (unsigned long long)board->free_cells, (unsigned long long)board->reward_sum);
+
+    move(start_y + 2, 1);
+    printw("Territory:");
+    for (unsigned int i = 0; i < state->player_count && i < MAX_PLAYERS; ++i)
+    {
+        short pair = player_color_pair(i);
+        if (pair)
+            attron(COLOR_PAIR(pair));
+        printw(" %u=%llu", i, (unsigned long long)board->owned_cells[i]);
+        if (pair)
+            attroff(COLOR_PAIR(pair));
+    }
+
+    mvprintw(start_y + 3, 1, "Visible: %llu free | %llu reward",
+             (unsigned long long)frame->visible.free_cells, (unsigned long long)frame->visible.reward_sum);
+}
+
+#define SPECTATOR_WAIT_MS 250 // con -s: cada cuánto se revisa SIGINT sin cambios
+#define SPECTATOR_COPY_TRIES 8 // con -s: copias descartadas por cruzarse con el master
+
 typedef struct
 {
     unsigned long width;
     unsigned long height;
+    bool spectator; // -s: se adjunta a una partida en curso sin que el master la espere
 } ViewArgs;
 
 typedef struct
@@ -147,16 +257,24 @@ typedef struct
     GameState *state;
     ShmADT sync_shm;
     GameSync *sync;
-    int *owner_map;
-    int *head_map;
+    ViewFrame frame;
 } ViewResources;
 
 static bool parse_args(int argc, char **argv, ViewArgs *out_args)
 {
+    // width/height se aceptan por compatibilidad con el master, pero el mapeo
+    // se dimensiona a partir de la cabecera del segmento
+    out_args->width = 0;
+    out_args->height = 0;
+    out_args->spectator = argc == 2 && strcmp(argv[1], "-s") == 0;
+    if (argc == 1 || out_args->spectator)
+    {
+        return true;
+    }
     if (argc != 3)
     {
         errno = EINVAL;
-        fprintf(stderr, "view: invalid usage. Usage: %s <width> <height>\n", argv[0]);
+        fprintf(stderr, "view: invalid usage. Usage: %s [<width> <height>] | -s\n", argv[0]);
         return false;
     }
 
@@ -175,17 +293,12 @@ static bool parse_args(int argc, char **argv, ViewArgs *out_args)
 
 static bool init_resources(const ViewArgs *args, ViewResources *out_res)
 {
-    size_t map_size = GAME_STATE_MAP_SIZE(args->width, args->height);
-
-    out_res->state_shm = open_shm(GAME_STATE_SHM_NAME, map_size, O_RDONLY, 0600, PROT_READ);
+    (void)args; // las dimensiones se toman de la cabecera del segmento
+    out_res->state_shm = game_state_open("view", &out_res->state);
     if (out_res->state_shm == NULL)
     {
-        fprintf(stderr,
-                "view: failed to open shm '%s' (read-only, size=%zu): %s\n",
-                GAME_STATE_SHM_NAME, map_size, strerror(errno));
         return false;
     }
-    out_res->state = (GameState *)get_shm_pointer(out_res->state_shm);
 
     out_res->sync_shm = open_shm(GAME_SYNC_SHM_NAME, sizeof(GameSync), O_RDWR, 0600, PROT_READ | PROT_WRITE);
     if (out_res->sync_shm == NULL)
@@ -198,27 +311,97 @@ static bool init_resources(const ViewArgs *args, ViewResources *out_res)
     }
     out_res->sync = (GameSync *)get_shm_pointer(out_res->sync_shm);
 
-    size_t cells = (size_t)out_res->state->width * (size_t)out_res->state->height;
-    out_res->owner_map = (int *)malloc(cells * sizeof(int));
-    out_res->head_map = (int *)malloc(cells * sizeof(int));
-
-    if (out_res->owner_map == NULL || out_res->head_map == NULL)
+    // En modo procedural el tablero no se copia entero (puede ser enorme):
+    // la ventana y las estadísticas se toman del segmento bajo el lock.
+    const GameState *state = out_res->state;
+    ViewFrame *frame = &out_res->frame;
+    *frame = (ViewFrame){0};
+    frame->snap_bytes = state->board_mode == BOARD_MODE_EAGER
+                            ? GAME_STATE_CHUNK_MAP_OFFSET(state->width, state->height, state->board_layout)
+                            : sizeof(GameState);
+    size_t alloc_bytes = (frame->snap_bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    frame->snap = aligned_alloc(CACHE_LINE_SIZE, alloc_bytes);
+    if (frame->snap == NULL)
     {
-        fprintf(stderr,
-                "view: out of memory for maps (cells=%zu, owner_map=%zu bytes, head_map=%zu bytes): %s\n",
-                cells, cells * sizeof(int), cells * sizeof(int), strerror(errno));
+        fprintf(stderr, "view: out of memory for the state snapshot (%zu bytes): %s\n",
+                alloc_bytes, strerror(errno));
         close_shm(out_res->sync_shm);
         close_shm(out_res->state_shm);
-        free(out_res->owner_map);
-        free(out_res->head_map);
         return false;
     }
 
-    for (size_t i = 0; i < cells; ++i)
-        out_res->owner_map[i] = -1;
-    for (size_t i = 0; i < cells; ++i)
-        out_res->head_map[i] = -1;
+    return true;
+}
+
+static void fill_viewport(const GameState *src, ViewFrame *frame)
+{
+    const Viewport *vp = &frame->vp;
+    for (unsigned int row = 0; row < vp->rows; ++row)
+        for (unsigned int col = 0; col < vp->cols; ++col)
+            frame->cells[(size_t)row * vp->cols + col] = board_get(src, vp->x0 + col, vp->y0 + row);
+    board_stats_rect(src, vp->x0, vp->y0, vp->cols, vp->rows, &frame->visible);
+}
 
+// Copia el estado y, si el tablero es procedural, lo que se lee del segmento
+// vivo (las celdas sin materializar no están en la copia)
+static void copy_frame(ViewResources *res, bool eager)
+{
+    ViewFrame *frame = &res->frame;
+    memcpy(frame->snap, res->state, frame->snap_bytes);
+    if (!eager)
+    {
+        frame->vp = compute_viewport(frame->snap);
+        fill_viewport(res->state, frame);
+        board_stats_board(res->state, &frame->board);
+    }
+}
+
+// Copia lo necesario para dibujar el frame. La vista de -v lo hace bajo el
+// lock de lector; un espectador, sin lock (ver game_sync_read_begin), porque
+// el master no debe depender de un proceso que se puede detener o matar.
+static bool capture_frame(ViewResources *res, bool lock_free)
+{
+    ViewFrame *frame = &res->frame;
+    // Cota de la ventana para el tamaño actual de la terminal (ver compute_viewport)
+    size_t max_cells = (size_t)(LINES > 1 ? LINES : 1) * (size_t)(COLS / CELL_W + 1);
+    if (max_cells > frame->cells_cap)
+    {
+        int *cells = realloc(frame->cells, max_cells * sizeof(int));
+        if (cells == NULL)
+        {
+            fprintf(stderr, "view: out of memory for the viewport (%zu cells)\n", max_cells);
+            return false;
+        }
+        frame->cells = cells;
+        frame->cells_cap = max_cells;
+    }
+
+    bool eager = res->state->board_mode == BOARD_MODE_EAGER;
+    if (lock_free)
+    {
+        // Si los intentos se agotan se dibuja igual: la escritura que se cruzó
+        // publica una generación nueva y el frame se rehace en la vuelta siguiente
+        for (int attempt = 0; attempt < SPECTATOR_COPY_TRIES; attempt++)
+        {
+            uint32_t seq = game_sync_read_begin(res->sync);
+            copy_frame(res, eager);
+            if (!game_sync_read_retry(res->sync, seq))
+                break;
+        }
+    }
+    else
+    {
+        game_sync_reader_enter(res->sync);
+        copy_frame(res, eager);
+        game_sync_reader_exit(res->sync);
+    }
+
+    if (eager)
+    {
+        frame->vp = compute_viewport(frame->snap);
+        fill_viewport(frame->snap, frame);
+        board_stats_board(frame->snap, &frame->board);
+    }
     return true;
 }
 
@@ -242,13 +425,52 @@ static void init_ncurses()
     }
 }
 
+// Dibuja el frame capturado. Devuelve si la partida terminó.
+static bool render_frame(const ViewFrame *frame)
+{
+    const GameState *state = frame->snap;
+    bool finished = state->finished;
+    TRACE_BEGIN(TRACE_VIEW_RENDER);
+    clear();
+    attron(A_BOLD);
+    mvprintw(0, 0, "==== JUEGO ====");
+    attroff(A_BOLD);
+    print_board(frame);
+    int players_y = 1 + (int)frame->vp.rows + 2;
+    print_players(state, players_y);
+    int summary_y = players_y + (int)state->player_count + 2;
+    print_summary(frame, summary_y);
+    mvprintw(summary_y + SUMMARY_LINES + 2, 0,
+             "finished=%s", finished ? "true" : "false");
+    refresh();
+    TRACE_END(TRACE_VIEW_RENDER);
+    return finished;
+}
+
+// Espectador (-s): sigue state_generation en vez del par de semáforos de la
+// vista, así que puede haber cualquier cantidad y el master no espera a
+// ninguno. Si dibujar tarda más que un movimiento, los intermedios se saltan.
+static void run_spectator_loop(ViewResources *res)
+{
+    uint32_t seen = game_sync_generation(res->sync);
+    bool changed = true; // el primer frame se dibuja al adjuntarse
+    while (!stop_requested)
+    {
+        if (changed)
+        {
+            // Leer la generación antes de copiar: un cambio durante la copia
+            // se vuelve a dibujar en la próxima vuelta
+            seen = game_sync_generation(res->sync);
+            if (!capture_frame(res, true) || render_frame(&res->frame))
+                break;
+        }
+        changed = game_sync_wait_generation(res->sync, seen, SPECTATOR_WAIT_MS);
+    }
+}
+
 static void run_view_loop(ViewResources *res)
 {
-    GameState *state = res->state;
     GameSync *sync = res->sync;
-    int *owner_map = res->owner_map;
-    int *head_map = res->head_map;
-    size_t cells = (size_t)state->width * (size_t)state->height;
 
     while (!stop_requested)
     {
@@ -262,31 +484,13 @@ static void run_view_loop(ViewResources *res)
             break;
         }
 
-        bool finished = false;
-        game_sync_reader_enter(sync);
-        clear();
-        attron(A_BOLD);
-        mvprintw(0, 0, "==== JUEGO ====");
-        attroff(A_BOLD);
-        for (size_t i = 0; i < cells; ++i)
-            head_map[i] = -1;
-        for (unsigned int i = 0; i < state->player_count && i < MAX_PLAYERS; ++i)
+        if (!capture_frame(res, false))
         {
-            unsigned int px = state->players[i].x;
-            unsigned int py = state->players[i].y;
-            if (px < state->width && py < state->height)
-            {
-                owner_map[py * state->width + px] = (int)i;
-                head_map[py * state->width + px] = (int)i;
-            }
+            sem_post(&sync->view_print_done); // no dejar al master esperando
+            break;
         }
-        print_board(state, owner_map, head_map);
-        print_players(state);
-        mvprintw((int)state->height + 3 + (int)state->player_count + 2, 0,
-                 "finished=%s", state->finished ? "true" : "false");
-        refresh();
-        finished = state->finished;
-        game_sync_reader_exit(sync);
+
+        bool finished = render_frame(&res->frame);
 
         if (sem_post(&sync->view_print_done) == -1)
         {
@@ -306,8 +510,8 @@ static void run_view_loop(ViewResources *res)
 static void cleanup_resources(ViewResources *res)
 {
     endwin();
-    free(res->owner_map);
-    free(res->head_map);
+    free(res->frame.snap);
+    free(res->frame.cells);
     // El master es responsable de desvincular la memoria compartida (shm_unlink).
     // Aquí solo cerramos nuestra vista local (munmap/close y liberar wrapper),
     // lo cual es seguro en presencia de shm_unlink del master.
@@ -337,8 +541,12 @@ int main(int argc, char **argv)
     }
 
     init_ncurses();
+    trace_attach("view");
 
-    run_view_loop(&res);
+    if (args.spectator)
+        run_spectator_loop(&res);
+    else
+        run_view_loop(&res);
 
     cleanup_resources(&res);
 